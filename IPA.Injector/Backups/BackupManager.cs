@@ -10,6 +10,7 @@ namespace IPA.Injector.Backups
             new DirectoryInfo(dir).Create();
             return new DirectoryInfo(dir)
                 .GetDirectories()
+                .Where(p => p.Name != BackupUnit.ObjectsDirName)
                 .OrderByDescending(p => p.Name)
                 .Select(p => BackupUnit.FromDirectory(p, dir))
                 .FirstOrDefault();
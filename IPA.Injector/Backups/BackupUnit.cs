@@ -2,20 +2,34 @@
 using System;
 using System.Collections.Generic;
 using System.IO;
+using System.Linq;
+using System.Security.Cryptography;
 
 namespace IPA.Injector.Backups
 {
     /// <summary>
     /// A unit for backup. WIP.
     /// </summary>
+    /// <remarks>
+    /// This uses the same format as the installer's backups: units with an index refer to the original contents of
+    /// their files by hash, in a store shared between units. Older units hold full copies of their files.
+    /// </remarks>
     internal class BackupUnit
     {
         public string Name { get; private set; }
         
+        private readonly string _dir;
         private readonly DirectoryInfo _backupPath;
         private readonly HashSet<string> _files = new HashSet<string>();
+        private readonly Dictionary<string, string> _hashes = new Dictionary<string, string>();
         private readonly FileInfo _manifestFile;
+        private readonly FileInfo _indexFile;
         private const string ManifestFileName = "$manifest$.txt";
+        internal const string IndexFileName = "$index$.txt";
+        internal const string ObjectsDirName = "$objects$";
+        private const string NoFile = "-";
+
+        private bool IsLegacy => !_indexFile.Exists;
 
         public BackupUnit(string dir) : this(dir, Utils.CurrentTime().ToString("yyyy-MM-dd_h-mm-ss"))
         {
@@ -24,16 +38,29 @@ namespace IPA.Injector.Backups
         private BackupUnit(string dir, string name)
         {
             Name = name;
+            _dir = dir;
             _backupPath = new DirectoryInfo(Path.Combine(dir, Name));
             _manifestFile = new FileInfo(Path.Combine(_backupPath.FullName, ManifestFileName));
+            _indexFile = new FileInfo(Path.Combine(_backupPath.FullName, IndexFileName));
         }
         
         public static BackupUnit FromDirectory(DirectoryInfo directory, string dir)
         {
             var unit = new BackupUnit(dir, directory.Name);
 
+            if (!unit.IsLegacy)
+            {
+                foreach (var line in File.ReadAllLines(unit._indexFile.FullName))
+                {
+                    var tab = line.IndexOf('\t');
+                    if (tab < 0) continue;
+                    var relativePath = line.Substring(tab + 1);
+                    unit._files.Add(relativePath);
+                    unit._hashes[relativePath] = line.Substring(0, tab); // later lines replace earlier ones
+                }
+            }
             // Read Manifest
-            if (unit._manifestFile.Exists)
+            else if (unit._manifestFile.Exists)
             {
                 var manifest = File.ReadAllText(unit._manifestFile.FullName);
                 foreach (var line in manifest.Split(new[] { Environment.NewLine, "\n", "\r" }, StringSplitOptions.RemoveEmptyEntries))
@@ -69,6 +96,23 @@ namespace IPA.Injector.Backups
         public void Add(FileInfo file)
         {
             var relativePath = Utilities.Utils.GetRelativePath(file.FullName, Environment.CurrentDirectory);
+
+            if (!IsLegacy)
+            {
+                var hash = file.Exists ? StoreObject(file) : NoFile;
+                _hashes.TryGetValue(relativePath, out var previous);
+                if (previous == hash) return;
+
+                _hashes[relativePath] = hash;
+                File.AppendAllText(_indexFile.FullName, $"{hash}\t{relativePath}{Environment.NewLine}");
+                if (_files.Add(relativePath) && hash == NoFile) // see the installer's BackupUnit for why
+                    File.AppendAllText(_manifestFile.FullName, relativePath + Environment.NewLine);
+
+                if (previous != null && previous != NoFile)
+                    PruneObject(previous);
+                return;
+            }
+
             var backupPath = new FileInfo(Path.Combine(_backupPath.FullName, relativePath));
             
             // Copy over
@@ -97,5 +141,59 @@ namespace IPA.Injector.Backups
             _files.Add(relativePath);
         }
 
+        private string StoreObject(FileInfo file)
+        {
+            string hash;
+            using (var sha = SHA256.Create())
+            using (var stream = file.OpenRead())
+                hash = BitConverter.ToString(sha.ComputeHash(stream)).Replace("-", "").ToLowerInvariant();
+
+            var objectPath = GetObjectPath(hash);
+            if (!File.Exists(objectPath))
+            {
+                Directory.CreateDirectory(Path.GetDirectoryName(objectPath));
+                var temp = objectPath + ".tmp";
+                file.CopyTo(temp, true);
+                File.Move(temp, objectPath);
+            }
+
+            return hash;
+        }
+
+        private string GetObjectPath(string hash)
+            => Path.Combine(Path.Combine(_dir, ObjectsDirName), Path.Combine(hash.Substring(0, 2), hash));
+
+        /// <summary>
+        /// Deletes the stored object with the given hash, unless some unit still refers to it.
+        /// </summary>
+        private void PruneObject(string hash)
+        {
+            try
+            {
+                foreach (var unitDir in new DirectoryInfo(_dir).GetDirectories())
+                {
+                    if (unitDir.Name == ObjectsDirName) continue;
+                    var index = Path.Combine(unitDir.FullName, IndexFileName);
+                    if (!File.Exists(index)) continue;
+                    // the last line for each file is the one that counts
+                    var current = new Dictionary<string, string>();
+                    foreach (var line in File.ReadAllLines(index))
+                    {
+                        var tab = line.IndexOf('\t');
+                        if (tab >= 0) current[line.Substring(tab + 1)] = line.Substring(0, tab);
+                    }
+                    if (current.ContainsValue(hash)) return;
+                }
+
+                File.Delete(GetObjectPath(hash));
+            }
+            catch (IOException)
+            { // it will be pruned the next time the installer reverts
+            }
+            catch (UnauthorizedAccessException)
+            {
+            }
+        }
+
     }
 }
@@ -41,6 +41,9 @@ namespace IPA.Injector
                     case "--plugin-logs":
                         SelfConfig.CommandLineValues.Debug.CreateModLogs = true;
                         break;
+                    case "--profile-load":
+                        SelfConfig.CommandLineValues.Debug.ProfilePluginLoading = true;
+                        break;
 #if false
                     case "--no-updates":
                         CommandLineValues.Updates.AutoCheckUpdates = false;
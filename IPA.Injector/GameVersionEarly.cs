@@ -3,6 +3,7 @@ using IPA.Utilities;
 using System;
 using System.Collections.Generic;
 using System.Diagnostics.CodeAnalysis;
+using System.Globalization;
 using System.IO;
 using System.Linq;
 using System.Text;
@@ -17,89 +18,200 @@ namespace IPA.Injector
         internal static string ResolveDataPath(string installDir) =>
             Directory.EnumerateDirectories(installDir, "*_Data").First();
 
+        private const int BufferSize = 81920;
+
+        private static string CachePath => Path.Combine(UnityGame.UserDataPath, ".GameVersionCache");
+
         private static string GetGameVersion()
         {
-            var filePath = Path.Combine(ResolveDataPath(UnityGame.InstallPath), GlobalGameManagersFileName);
-            using var fileStream = File.OpenRead(filePath);
-            using var binaryReader = new BinaryReader(fileStream, Encoding.UTF8);
+            var file = new FileInfo(Path.Combine(ResolveDataPath(UnityGame.InstallPath), GlobalGameManagersFileName));
+
+            // the file is several megabytes, and only changes when the game updates
+            if (TryGetCachedVersion(file, out var cached))
+                return cached;
 
-            if (!TrySeekToKey(binaryReader, AppStoreCategory))
+            using var fileStream = new FileStream(file.FullName, FileMode.Open, FileAccess.Read, FileShare.Read, 1, FileOptions.SequentialScan);
+
+            var keyEnd = FindKey(fileStream, Encoding.UTF8.GetBytes(AppStoreCategory));
+            if (keyEnd < 0)
             {
                 throw new KeyNotFoundException($"Could not find key '{AppStoreCategory}' in {GlobalGameManagersFileName}");
             }
 
-            if (!TryFindVersion(binaryReader, out var gameVersion))
+            if (!TryFindVersion(fileStream, keyEnd, out var gameVersion))
             {
                 throw new InvalidDataException($"Could not find a valid game version string in {GlobalGameManagersFileName}");
             }
 
+            CacheVersion(file, gameVersion);
             return gameVersion;
         }
 
-        private static bool TrySeekToKey(BinaryReader reader, string key)
+        private static bool TryGetCachedVersion(FileInfo file, [MaybeNullWhen(false)] out string version)
         {
-            var position = 0;
-            var stream = reader.BaseStream;
-            while (stream.Position < stream.Length && position < key.Length)
+            version = null;
+            try
             {
-                if (reader.ReadByte() == key[position])
-                {
-                    position++;
-                }
-                else
-                {
-                    position = 0;
-                }
+                if (!File.Exists(CachePath)) return false;
+
+                var lines = File.ReadAllLines(CachePath);
+                if (lines.Length != 4
+                    || lines[0] != file.FullName
+                    || lines[1] != file.Length.ToString(CultureInfo.InvariantCulture)
+                    || lines[2] != file.LastWriteTimeUtc.Ticks.ToString(CultureInfo.InvariantCulture))
+                    return false;
+
+                version = lines[3];
+                return version.Length > 0;
+            }
+            catch (Exception e) when (e is IOException or UnauthorizedAccessException)
+            {
+                return false;
             }
+        }
 
-            return stream.Position != stream.Length;
+        private static void CacheVersion(FileInfo file, string version)
+        {
+            try
+            {
+                File.WriteAllLines(CachePath, new[]
+                {
+                    file.FullName,
+                    file.Length.ToString(CultureInfo.InvariantCulture),
+                    file.LastWriteTimeUtc.Ticks.ToString(CultureInfo.InvariantCulture),
+                    version,
+                });
+            }
+            catch (Exception e) when (e is IOException or UnauthorizedAccessException)
+            { // it'll just be scanned again next time
+            }
         }
 
-        private static bool TryFindVersion(BinaryReader reader, [MaybeNullWhen(false)] out string version)
+        /// <summary>
+        /// Finds the first occurrence of <paramref name="key"/> in <paramref name="stream"/> with Boyer-Moore-Horspool,
+        /// reading large blocks at a time.
+        /// </summary>
+        /// <returns>the position just after the key, or -1 if it wasn't found</returns>
+        internal static long FindKey(Stream stream, byte[] key)
         {
-            var stream = reader.BaseStream;
-            while (stream.Position < stream.Length)
+            var skip = new int[256];
+            for (var i = 0; i < skip.Length; i++)
+                skip[i] = key.Length;
+            for (var i = 0; i < key.Length - 1; i++)
+                skip[key[i]] = key.Length - 1 - i;
+
+            var buffer = new byte[BufferSize];
+            var last = key.Length - 1;
+            long bufferStart = 0;
+            var count = 0;
+
+            while (true)
             {
-                var current = (char)reader.ReadByte();
+                // keep the tail of the last block, in case the key straddles two of them
+                var keep = Math.Min(count, last);
+                Buffer.BlockCopy(buffer, count - keep, buffer, 0, keep);
+                bufferStart += count - keep;
+                count = keep;
 
-                if (!char.IsDigit(current))
+                var read = stream.Read(buffer, count, buffer.Length - count);
+                if (read <= 0) return -1;
+                count += read;
+
+                for (var pos = 0; pos + last < count; pos += skip[buffer[pos + last]])
                 {
-                    continue;
+                    var i = last;
+                    while (i >= 0 && buffer[pos + i] == key[i])
+                        i--;
+                    if (i < 0)
+                        return bufferStart + pos + key.Length;
                 }
+            }
+        }
 
-                var bytesRead = 1;
-                var dotCount = 0;
+        /// <summary>
+        /// Finds the first run of digits after <paramref name="start"/> that contains two dots, and reads the
+        /// length-prefixed string that it starts.
+        /// </summary>
+        internal static bool TryFindVersion(Stream stream, long start, [MaybeNullWhen(false)] out string version)
+        {
+            const int prefix = sizeof(int);
+            var buffer = new byte[4096];
 
-                while (stream.Position < stream.Length)
-                {
-                    current = (char)reader.ReadByte();
-                    bytesRead++;
+            var pos = start; // where to start looking for a digit
+            while (true)
+            {
+                // each window includes the bytes before pos that could be a length prefix
+                var windowStart = Math.Max(0, pos - prefix);
+                _ = stream.Seek(windowStart, SeekOrigin.Begin);
+                var count = ReadFully(stream, buffer);
+                var atEnd = count < buffer.Length;
 
-                    if (current == '.')
-                    {
-                        dotCount++;
-                    }
-                    else if (!char.IsDigit(current))
+                var i = (int)(pos - windowStart);
+                var first = i;
+                if (i >= count) break;
+
+                while (i < count)
+                {
+                    if (!char.IsDigit((char)buffer[i]))
                     {
-                        break;
+                        i++;
+                        continue;
                     }
 
-                    // Ensures we get a valid SemVer.
-                    if (dotCount == 2)
+                    var digitStart = i;
+                    var dotCount = 0;
+                    for (i++; i < count; i++)
                     {
-                        stream.Seek(-bytesRead - sizeof(int), SeekOrigin.Current);
-                        var lengthPrefix = reader.ReadInt32();
-                        version = Encoding.UTF8.GetString(reader.ReadBytes(lengthPrefix));
+                        var current = (char)buffer[i];
+                        if (current == '.')
+                        {
+                            dotCount++;
+                        }
+                        else if (!char.IsDigit(current))
+                        {
+                            break;
+                        }
+
+                        // Ensures we get a valid SemVer.
+                        if (dotCount == 2)
+                        {
+                            var lengthAt = windowStart + digitStart - prefix;
+                            if (lengthAt < 0) break; // there's no room for a length before it
+                            _ = stream.Seek(lengthAt, SeekOrigin.Begin);
+                            using var reader = new BinaryReader(stream, Encoding.UTF8, true);
+                            var lengthPrefix = reader.ReadInt32();
+                            version = Encoding.UTF8.GetString(reader.ReadBytes(lengthPrefix));
+
+                            return true;
+                        }
+                    }
 
-                        return true;
+                    if (i >= count && !atEnd && digitStart != first)
+                    { // the run goes past this window, so look at it again from the start of the next one
+                        i = digitStart;
+                        break;
                     }
+
+                    i++; // the byte that ended the run can't start one
                 }
+
+                if (atEnd) break;
+                pos = windowStart + i;
             }
 
             version = null;
             return false;
         }
 
+        private static int ReadFully(Stream stream, byte[] buffer)
+        {
+            var count = 0;
+            int read;
+            while (count < buffer.Length && (read = stream.Read(buffer, count, buffer.Length - count)) > 0)
+                count += read;
+            return count;
+        }
+
         private static AlmostVersion SafeParseVersion() => new(GetGameVersion());
 
         private static void _Load()
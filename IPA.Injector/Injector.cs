@@ -9,8 +9,11 @@ using Mono.Cecil;
 using Mono.Cecil.Cil;
 using System;
 using System.Diagnostics;
+using System.Globalization;
 using System.IO;
+using System.Linq;
 using System.Reflection;
+using System.Security.Cryptography;
 using System.Threading.Tasks;
 using UnityEngine;
 using MethodAttributes = Mono.Cecil.MethodAttributes;
@@ -125,112 +128,191 @@ namespace IPA.Injector
             if (bkp == null)
                 Logging.Logger.Injector.Warn("No backup found! Was BSIPA installed using the installer?");
 
-            // TODO: Investigate if this ever worked properly.
-            // this is a critical section because if you exit in here, assembly can die
-            using var critSec = CriticalSection.ExecuteSection();
+            var unityPath = Path.Combine(managedPath, "UnityEngine.CoreModule.dll");
+            var fingerprintPath = Path.Combine(backupPath, "UnityEngine.CoreModule.patched");
+            var injectorId = $"{cAsmName.FullName} {Assembly.GetExecutingAssembly().ManifestModule.ModuleVersionId}";
 
-            var readerParameters = new ReaderParameters
+            // the patch only needs to be (re)applied when either CoreModule or we have changed since it last was
+            if (PatchFingerprintMatches(unityPath, fingerprintPath, injectorId))
             {
-                ReadWrite = false,
-                InMemory = true,
-                ReadingMode = ReadingMode.Immediate
-            };
+                Logging.Logger.Injector.Debug("UnityEngine.CoreModule is already patched");
+            }
+            else
+            {
+                // TODO: Investigate if this ever worked properly.
+                // this is a critical section because if you exit in here, assembly can die
+                using var critSec = CriticalSection.ExecuteSection();
 
-            Logging.Logger.Injector.Debug("Ensuring patch on UnityEngine.CoreModule exists");
+                Logging.Logger.Injector.Debug("Ensuring patch on UnityEngine.CoreModule exists");
 
-            #region Insert patch into UnityEngine.CoreModule.dll
+                if (PatchCoreModule(unityPath, cAsmName, bkp))
+                    WritePatchFingerprint(unityPath, fingerprintPath, injectorId);
+            }
 
-            var unityPath = Path.Combine(managedPath, "UnityEngine.CoreModule.dll");
+            sw.Stop();
+            Logging.Logger.Injector.Info($"Installing bootstrapper took {sw.Elapsed}");
+        }
 
-            using var unityAsmDef = AssemblyDefinition.ReadAssembly(unityPath, readerParameters);
-            var unityModDef = unityAsmDef.MainModule;
+        /// <summary>
+        /// Makes sure that UnityEngine.CoreModule calls <see cref="CreateBootstrapper"/>, and references this version
+        /// of the injector.
+        /// </summary>
+        /// <returns><see langword="true"/> if the assembly is now patched, <see langword="false"/> if it can't be</returns>
+        private static bool PatchCoreModule(string unityPath, AssemblyName cAsmName, BackupUnit? bkp)
+        {
+            // read straight from the file, so only the parts we look at are loaded unless we have to write it
+            var readerParameters = new ReaderParameters
+            {
+                ReadWrite = false,
+                InMemory = false,
+                ReadingMode = ReadingMode.Deferred
+            };
 
+            var tempFilePath = unityPath + ".tmp";
             bool modified = false;
-            foreach (var asmref in unityModDef.AssemblyReferences)
+
+            using (var unityAsmDef = AssemblyDefinition.ReadAssembly(unityPath, readerParameters))
             {
-                if (asmref.Name == cAsmName.Name)
+                var unityModDef = unityAsmDef.MainModule;
+
+                foreach (var asmref in unityModDef.AssemblyReferences)
                 {
-                    if (asmref.Version != cAsmName.Version)
+                    if (asmref.Name == cAsmName.Name)
                     {
-                        asmref.Version = cAsmName.Version;
-                        modified = true;
+                        if (asmref.Version != cAsmName.Version)
+                        {
+                            asmref.Version = cAsmName.Version;
+                            modified = true;
+                        }
                     }
                 }
-            }
 
-            var application = unityModDef.GetType("UnityEngine", "Camera");
+                var application = unityModDef.GetType("UnityEngine", "Camera");
 
-            if (application == null)
-            {
-                Logging.Logger.Injector.Critical("UnityEngine.CoreModule doesn't have a definition for UnityEngine.Camera!"
-                    + "Nothing to patch to get ourselves into the Unity run cycle!");
-                goto endPatchCoreModule;
-            }
+                if (application == null)
+                {
+                    Logging.Logger.Injector.Critical("UnityEngine.CoreModule doesn't have a definition for UnityEngine.Camera!"
+                        + "Nothing to patch to get ourselves into the Unity run cycle!");
+                    return false;
+                }
 
-            MethodDefinition? cctor = null;
-            foreach (var m in application.Methods)
-                if (m.IsRuntimeSpecialName && m.Name == ".cctor")
-                    cctor = m;
+                MethodDefinition? cctor = null;
+                foreach (var m in application.Methods)
+                    if (m.IsRuntimeSpecialName && m.Name == ".cctor")
+                        cctor = m;
 
-            var cbs = unityModDef.ImportReference(((Action)CreateBootstrapper).Method);
+                var cbs = unityModDef.ImportReference(((Action)CreateBootstrapper).Method);
 
-            if (cctor == null)
-            {
-                cctor = new MethodDefinition(".cctor",
-                    MethodAttributes.RTSpecialName | MethodAttributes.Static | MethodAttributes.SpecialName,
-                    unityModDef.TypeSystem.Void);
-                application.Methods.Add(cctor);
-                modified = true;
-
-                var ilp = cctor.Body.GetILProcessor();
-                ilp.Emit(OpCodes.Call, cbs);
-                ilp.Emit(OpCodes.Ret);
-            }
-            else
-            {
-                var ilp = cctor.Body.GetILProcessor();
-                for (var i = 0; i < Math.Min(2, cctor.Body.Instructions.Count); i++)
+                if (cctor == null)
+                {
+                    cctor = new MethodDefinition(".cctor",
+                        MethodAttributes.RTSpecialName | MethodAttributes.Static | MethodAttributes.SpecialName,
+                        unityModDef.TypeSystem.Void);
+                    application.Methods.Add(cctor);
+                    modified = true;
+
+                    var ilp = cctor.Body.GetILProcessor();
+                    ilp.Emit(OpCodes.Call, cbs);
+                    ilp.Emit(OpCodes.Ret);
+                }
+                else
                 {
-                    var ins = cctor.Body.Instructions[i];
-                    switch (i)
+                    var ilp = cctor.Body.GetILProcessor();
+                    for (var i = 0; i < Math.Min(2, cctor.Body.Instructions.Count); i++)
                     {
-                        case 0 when ins.OpCode != OpCodes.Call:
-                            ilp.Replace(ins, ilp.Create(OpCodes.Call, cbs));
-                            modified = true;
-                            break;
+                        var ins = cctor.Body.Instructions[i];
+                        switch (i)
+                        {
+                            case 0 when ins.OpCode != OpCodes.Call:
+                                ilp.Replace(ins, ilp.Create(OpCodes.Call, cbs));
+                                modified = true;
+                                break;
 
-                        case 0:
-                            {
-                                var methodRef = ins.Operand as MethodReference;
-                                if (methodRef?.FullName != cbs.FullName)
+                            case 0:
                                 {
-                                    ilp.Replace(ins, ilp.Create(OpCodes.Call, cbs));
-                                    modified = true;
+                                    var methodRef = ins.Operand as MethodReference;
+                                    if (methodRef?.FullName != cbs.FullName)
+                                    {
+                                        ilp.Replace(ins, ilp.Create(OpCodes.Call, cbs));
+                                        modified = true;
+                                    }
+
+                                    break;
                                 }
-
+                            case 1 when ins.OpCode != OpCodes.Ret:
+                                ilp.Replace(ins, ilp.Create(OpCodes.Ret));
+                                modified = true;
                                 break;
-                            }
-                        case 1 when ins.OpCode != OpCodes.Ret:
-                            ilp.Replace(ins, ilp.Create(OpCodes.Ret));
-                            modified = true;
-                            break;
+                        }
                     }
                 }
+
+                if (modified)
+                {
+                    // written next to the original, so that replacing it is just a rename
+                    using var tempFile = new FileStream(tempFilePath, FileMode.Create, FileAccess.Write, FileShare.None);
+                    unityAsmDef.Write(tempFile);
+                }
             }
 
             if (modified)
-            {
-                string tempFilePath = Path.GetTempFileName();
+            { // the original has to be closed before it can be replaced
                 bkp?.Add(unityPath);
-                unityAsmDef.Write(tempFilePath);
                 File.Delete(unityPath);
                 File.Move(tempFilePath, unityPath);
             }
-            endPatchCoreModule:
-            #endregion Insert patch into UnityEngine.CoreModule.dll
 
-            sw.Stop();
-            Logging.Logger.Injector.Info($"Installing bootstrapper took {sw.Elapsed}");
+            return true;
+        }
+
+        private static string[] GetPatchFingerprint(string unityPath, string injectorId)
+        {
+            var info = new FileInfo(unityPath);
+            using var sha = SHA256.Create();
+            using var stream = new FileStream(unityPath, FileMode.Open, FileAccess.Read, FileShare.Read, 81920, FileOptions.SequentialScan);
+            return new[]
+            {
+                injectorId,
+                info.Length.ToString(CultureInfo.InvariantCulture),
+                info.LastWriteTimeUtc.Ticks.ToString(CultureInfo.InvariantCulture),
+                BitConverter.ToString(sha.ComputeHash(stream)).Replace("-", ""),
+            };
+        }
+
+        private static bool PatchFingerprintMatches(string unityPath, string fingerprintPath, string injectorId)
+        {
+            try
+            {
+                if (!File.Exists(fingerprintPath)) return false;
+
+                var stored = File.ReadAllLines(fingerprintPath);
+                var info = new FileInfo(unityPath);
+                // check the cheap parts first, so that a changed file doesn't also get hashed
+                if (stored.Length != 4
+                    || stored[0] != injectorId
+                    || stored[1] != info.Length.ToString(CultureInfo.InvariantCulture)
+                    || stored[2] != info.LastWriteTimeUtc.Ticks.ToString(CultureInfo.InvariantCulture))
+                    return false;
+
+                return stored.SequenceEqual(GetPatchFingerprint(unityPath, injectorId));
+            }
+            catch (Exception e) when (e is IOException or UnauthorizedAccessException)
+            {
+                return false;
+            }
+        }
+
+        private static void WritePatchFingerprint(string unityPath, string fingerprintPath, string injectorId)
+        {
+            try
+            {
+                File.WriteAllLines(fingerprintPath, GetPatchFingerprint(unityPath, injectorId));
+            }
+            catch (Exception e) when (e is IOException or UnauthorizedAccessException)
+            {
+                Logging.Logger.Injector.Warn("Could not save the UnityEngine.CoreModule patch state; it will be checked again next launch");
+                Logging.Logger.Injector.Warn(e);
+            }
         }
 
         private static bool bootstrapped;
@@ -24,6 +24,7 @@ using System.Runtime.InteropServices;
 // The following GUID is for the ID of the typelib if this project is exposed to COM
 [assembly: Guid("2a1af16b-27f1-46e0-9a95-181516bc1cb7")]
 [assembly: InternalsVisibleTo("IPA.Loader")]
+[assembly: InternalsVisibleTo("IPA.Tests")]
 
 // Version information for an assembly consists of the following four values:
 //
@@ -51,7 +51,7 @@ namespace IPA.AntiMalware
 
             AmsiScanBuffer(handle, data, (uint)data.Length, contentName, IntPtr.Zero, out var result);
 
-            Logger.AntiMalware.Trace($"Scanned data named '{contentName}' and got '{result}'");
+            Logger.AntiMalware.Trace("Scanned data named '{0}' and got '{1}'", contentName, result);
             return ScanResultFromAmsiResult(result);
         }
 
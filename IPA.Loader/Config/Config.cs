@@ -135,7 +135,11 @@ namespace IPA.Config
         internal IConfigStore Store = null;
         internal readonly FileInfo File;
         internal readonly ConfigProvider configProvider;
-        internal int Writes = 0;
+
+        // save scheduling state, owned by ConfigRuntime
+        internal int SavePending = 0;
+        internal long FirstSaveRequestTicks = 0;
+        internal long LastSaveRequestTicks = 0;
 
         /// <summary>
         /// Sets this object's <see cref="IConfigStore"/>. Can only be called once.
@@ -147,7 +151,7 @@ namespace IPA.Config
             if (Store != null)
                 throw new InvalidOperationException($"{nameof(SetStore)} can only be called once");
             Store = store;
-            ConfigRuntime.ConfigChanged();
+            ConfigRuntime.ConfigChanged(this);
         }
 
         /// <summary>
@@ -160,7 +164,7 @@ namespace IPA.Config
         /// </summary>
         public Task LoadAsync() => ConfigRuntime.TriggerFileLoad(this);
 
-        private Config(string name, IConfigProvider provider, FileInfo file)
+        internal Config(string name, IConfigProvider provider, FileInfo file)
         {
             Name = name; Provider = provider; File = file;
             configProvider = new ConfigProvider(file, provider);
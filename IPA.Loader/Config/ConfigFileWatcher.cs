@@ -0,0 +1,191 @@
+﻿#nullable enable
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using Logger = IPA.Logging.Logger;
+
+namespace IPA.Config
+{
+    /// <summary>
+    /// Watches the files of every registered <see cref="Config"/> (and other config-like files, like
+    /// <see cref="IniFile"/>s), and reloads them when they are changed externally.
+    /// </summary>
+    /// <remarks>
+    /// <para>
+    /// All files share as few recursive watchers as possible (usually just one, on <c>UserData</c>), and events are
+    /// matched to their handler with a path index.
+    /// </para>
+    /// <para>
+    /// Events for a file are coalesced until it has been quiet for <see cref="CoalesceDelay"/>, so that an editor's
+    /// truncate, write, and rename result in a single reload.
+    /// </para>
+    /// </remarks>
+    internal static class ConfigFileWatcher
+    {
+        private const int CoalesceDelay = 100; // ms
+
+        internal static readonly StringComparer PathComparer =
+            Environment.OSVersion.Platform == PlatformID.Win32NT ? StringComparer.OrdinalIgnoreCase : StringComparer.Ordinal;
+        private static readonly StringComparison pathComparison =
+            Environment.OSVersion.Platform == PlatformID.Win32NT ? StringComparison.OrdinalIgnoreCase : StringComparison.Ordinal;
+
+        private static readonly object watchersLock = new();
+        private static readonly List<FileSystemWatcher> watchers = new();
+        // several handlers for one file are combined into one multicast delegate
+        private static readonly ConcurrentDictionary<string, Action> handlersByPath = new(PathComparer);
+
+        // the file to reload, and the time of the last event for it
+        private static readonly ConcurrentDictionary<string, int> pendingReloads = new(PathComparer);
+        private static readonly Timer flushTimer = new(_ => FlushReloads(), null, Timeout.Infinite, Timeout.Infinite);
+        private static int flushScheduled;
+        private static volatile bool shutdown;
+
+        public static void Watch(Config config)
+            => Watch(config.File, () =>
+            {
+                // our own saves show up here too, but leave the file exactly as we wrote it
+                if (!config.configProvider.IsUnchangedSinceStore())
+                    _ = ConfigRuntime.TriggerFileLoad(config);
+            });
+
+        /// <summary>
+        /// Calls <paramref name="changed"/> on a thread pool thread whenever <paramref name="file"/> changes, after
+        /// it has settled. Any handlers already registered for the file are kept.
+        /// </summary>
+        public static void Watch(FileInfo file, Action changed)
+        {
+            _ = handlersByPath.AddOrUpdate(file.FullName, changed, (_, existing) => existing + changed);
+
+            var dir = file.Directory.FullName;
+            lock (watchersLock)
+            {
+                if (watchers.Any(w => IsWithin(dir, w.Path)))
+                    return;
+
+                // the new watcher covers any that were watching subdirectories of it
+                foreach (var sub in watchers.Where(w => IsWithin(w.Path, dir)).ToArray())
+                {
+                    sub.EnableRaisingEvents = false;
+                    sub.Dispose();
+                    _ = watchers.Remove(sub);
+                }
+
+                var watcher = new FileSystemWatcher(dir)
+                {
+                    IncludeSubdirectories = true,
+                    NotifyFilter =
+                        NotifyFilters.FileName
+                        | NotifyFilters.LastWrite
+                        | NotifyFilters.Size
+                        | NotifyFilters.CreationTime,
+                };
+
+                watcher.Changed += FileChangedEvent;
+                watcher.Created += FileChangedEvent;
+                watcher.Renamed += FileChangedEvent;
+                watcher.Deleted += FileChangedEvent;
+                watcher.Error += WatcherError;
+
+                watchers.Add(watcher);
+                watcher.EnableRaisingEvents = !shutdown;
+            }
+        }
+
+        public static FileSystemWatcher[] GetWatchers()
+        {
+            lock (watchersLock)
+                return watchers.ToArray();
+        }
+
+        public static void Shutdown()
+        {
+            shutdown = true;
+            lock (watchersLock)
+            {
+                foreach (var watcher in watchers)
+                    watcher.EnableRaisingEvents = false;
+            }
+
+            _ = flushTimer.Change(Timeout.Infinite, Timeout.Infinite);
+            pendingReloads.Clear();
+        }
+
+        private static bool IsWithin(string path, string root)
+        {
+            path = path.TrimEnd(Path.DirectorySeparatorChar, Path.AltDirectorySeparatorChar) + Path.DirectorySeparatorChar;
+            root = root.TrimEnd(Path.DirectorySeparatorChar, Path.AltDirectorySeparatorChar) + Path.DirectorySeparatorChar;
+            return path.StartsWith(root, pathComparison);
+        }
+
+        private static void FileChangedEvent(object sender, FileSystemEventArgs e)
+        {
+            MarkChanged(e.FullPath);
+            if (e is RenamedEventArgs renamed)
+                MarkChanged(renamed.OldFullPath);
+        }
+
+        private static void MarkChanged(string path)
+        {
+            if (shutdown || !handlersByPath.ContainsKey(path)) return;
+
+            pendingReloads[path] = Environment.TickCount;
+            ScheduleFlush();
+        }
+
+        private static void ScheduleFlush()
+        {
+            if (Interlocked.Exchange(ref flushScheduled, 1) == 0)
+                _ = flushTimer.Change(CoalesceDelay, Timeout.Infinite);
+        }
+
+        private static void FlushReloads()
+        {
+            Volatile.Write(ref flushScheduled, 0);
+            if (shutdown) return;
+
+            var now = Environment.TickCount;
+            var waiting = false;
+            foreach (var pair in pendingReloads)
+            {
+                if (unchecked(now - pair.Value) < CoalesceDelay)
+                {
+                    waiting = true;
+                    continue;
+                }
+
+                // only remove the entry we looked at, so that an event that just came in isn't lost
+                if (!((ICollection<KeyValuePair<string, int>>)pendingReloads).Remove(pair))
+                {
+                    waiting = true;
+                    continue;
+                }
+
+                if (!handlersByPath.TryGetValue(pair.Key, out var handlers)) continue;
+                foreach (Action handler in handlers.GetInvocationList())
+                {
+                    try
+                    {
+                        handler();
+                    }
+                    catch (Exception e)
+                    {
+                        Logger.Config.Error($"Error handling change to {pair.Key}");
+                        Logger.Config.Error(e);
+                    }
+                }
+            }
+
+            if (waiting)
+                ScheduleFlush();
+        }
+
+        private static void WatcherError(object sender, ErrorEventArgs e)
+        {
+            Logger.Config.Warn($"Config file watcher for {((FileSystemWatcher)sender).Path} errored; some external changes may be missed");
+            Logger.Config.Warn(e.GetException());
+        }
+    }
+}
@@ -2,6 +2,7 @@
 using System;
 using System.Collections.Concurrent;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.IO;
 using System.Linq;
 using System.Threading;
@@ -12,20 +13,11 @@ namespace IPA.Config
 {
     internal static class ConfigRuntime
     {
-        private class DirInfoEqComparer : IEqualityComparer<DirectoryInfo>
-        {
-            public bool Equals(DirectoryInfo x, DirectoryInfo y)
-                => x?.FullName == y?.FullName;
-
-            public int GetHashCode(DirectoryInfo obj)
-                => obj?.FullName.GetHashCode() ?? 0;
-        }
-
         private static readonly ConcurrentBag<Config> configs = new();
         private static readonly AutoResetEvent configsChangedWatcher = new(false);
-        private static readonly ConcurrentDictionary<DirectoryInfo, FileSystemWatcher> watchers = new(new DirInfoEqComparer());
-        private static readonly ConcurrentDictionary<FileSystemWatcher, ConcurrentBag<Config>> watcherTrackConfigs = new();
-        private static BlockingCollection<IConfigStore> requiresSave = new();
+        private static readonly ConcurrentDictionary<ReaderWriterLockSlim, Config> configsByWriteSync = new();
+        private static readonly ConcurrentQueue<Config> saveRequests = new();
+        private static readonly AutoResetEvent saveRequested = new(false);
         private static SingleThreadTaskScheduler loadScheduler;
         private static TaskFactory loadFactory;
         private static Thread saveThread;
@@ -56,9 +48,38 @@ namespace IPA.Config
             AppDomain.CurrentDomain.ProcessExit += ShutdownRuntime;
         }
 
+        // a config that keeps changing is still saved at least this many debounce windows after its first change
+        internal const int MaxSaveDelayFactor = 8;
+
         internal static void AddRequiresSave(IConfigStore configStore)
         {
-            requiresSave?.Add(configStore);
+            var writeSync = configStore.WriteSyncObject;
+            if (!configsByWriteSync.TryGetValue(writeSync, out var config))
+            { // the store may have been set before it was indexed
+                config = configs.FirstOrDefault(c => c.Store != null && ReferenceEquals(c.Store.WriteSyncObject, writeSync));
+                if (config == null) return;
+                configsByWriteSync[writeSync] = config;
+            }
+
+            RequestSave(config);
+        }
+
+        /// <summary>
+        /// Schedules <paramref name="config"/> to be saved once it has stopped changing for a moment.
+        /// </summary>
+        /// <remarks>
+        /// Any number of requests for the same config before the save thread gets to it result in a single write.
+        /// </remarks>
+        private static void RequestSave(Config config)
+        {
+            var now = Stopwatch.GetTimestamp();
+            Volatile.Write(ref config.LastSaveRequestTicks, now);
+            if (Interlocked.Exchange(ref config.SavePending, 1) == 0)
+            {
+                config.FirstSaveRequestTicks = now;
+                saveRequests.Enqueue(config);
+                _ = saveRequested.Set();
+            }
         }
 
         private static void ShutdownRuntime(object sender, EventArgs e)
@@ -67,21 +88,16 @@ namespace IPA.Config
         {
             try
             {
-                watcherTrackConfigs.Clear();
-                var watchList = watchers.ToArray();
-                watchers.Clear();
-
-                foreach (var pair in watchList)
-                    pair.Value.EnableRaisingEvents = false;
+                ConfigFileWatcher.Shutdown();
 
                 loadScheduler.Join(); // we can wait for the loads to finish
                 saveThread.Abort(); // eww, but i don't like any of the other potential solutions
                 legacySaveThread.Abort();
 
-                SaveAll();
+                SaveAll(); // this also flushes anything that was waiting out its debounce
+                IniFile.FlushAll(); // ProcessExit isn't reliably raised under Unity, so don't leave ModPrefs writes to it
 
-                requiresSave.Dispose();
-                requiresSave = null;
+                Stores.GeneratedStoreImpl.SaveCache();
             }
             catch
             {
@@ -101,71 +117,18 @@ namespace IPA.Config
 
             TryStartRuntime();
 
-            AddConfigToWatchers(cfg);
+            ConfigFileWatcher.Watch(cfg);
         }
 
-        public static void ConfigChanged()
+        public static void ConfigChanged(Config config)
         {
+            if (config.Store != null)
+                configsByWriteSync[config.Store.WriteSyncObject] = config;
             configsChangedWatcher.Set();
         }
 
-        private static void AddConfigToWatchers(Config config)
-        {
-            var dir = config.File.Directory;
-            if (!watchers.TryGetValue(dir, out var watcher))
-            { // create the watcher
-                watcher = watchers.GetOrAdd(dir, dir => new FileSystemWatcher(dir.FullName));
-
-                watcher.NotifyFilter =
-                    NotifyFilters.FileName
-                    | NotifyFilters.LastWrite
-                    | NotifyFilters.Size
-                    | NotifyFilters.LastAccess
-                    | NotifyFilters.Attributes
-                    | NotifyFilters.CreationTime;
-
-                watcher.Changed += FileChangedEvent;
-                watcher.Created += FileChangedEvent;
-                watcher.Renamed += FileChangedEvent;
-                watcher.Deleted += FileChangedEvent;
-            }
-
-            TryStartRuntime();
-
-            watcher.EnableRaisingEvents = false; // disable while we do shit
-
-            var bag = watcherTrackConfigs.GetOrAdd(watcher, w => new ConcurrentBag<Config>());
-            // we don't need to check containment because this function will only be called once per config ever
-            bag.Add(config);
-
-            watcher.EnableRaisingEvents = true;
-        }
-
         internal static FileSystemWatcher[] GetWatchers()
-        {
-            return watcherTrackConfigs.Keys.ToArray();
-        }
-
-        private static void EnsureWritesSane(Config config)
-        {
-            // compare exchange loop to be sane
-            var writes = config.Writes;
-            while (writes < 0)
-                writes = Interlocked.CompareExchange(ref config.Writes, 0, writes);
-        }
-
-        private static void FileChangedEvent(object sender, FileSystemEventArgs e)
-        {
-            var watcher = sender as FileSystemWatcher;
-            if (!watcherTrackConfigs.TryGetValue(watcher, out var bag)) return;
-
-            var config = bag.FirstOrDefault(c => c.File.FullName == e.FullPath);
-            if (config != null && Interlocked.Decrement(ref config.Writes) + 1 <= 0)
-            {
-                EnsureWritesSane(config);
-                TriggerFileLoad(config);
-            }
-        }
+            => ConfigFileWatcher.GetWatchers();
 
         public static Task TriggerFileLoad(Config config)
             => loadFactory.StartNew(() => LoadTask(config));
@@ -185,8 +148,6 @@ namespace IPA.Config
             {
                 using var readLock = Synchronization.LockRead(store.WriteSyncObject);
 
-                EnsureWritesSane(config);
-                Interlocked.Increment(ref config.Writes);
                 store.WriteTo(config.configProvider);
             }
             catch (ThreadAbortException)
@@ -226,18 +187,43 @@ namespace IPA.Config
 
         private static void SaveThread()
         {
-            if (requiresSave == null)
-            {
-                return;
-            }
+            var pending = new List<Config>();
 
             try
             {
-                foreach (var item in requiresSave.GetConsumingEnumerable())
+                while (true)
                 {
                     try
                     {
-                        Save(configs.First((c) => c.Store != null && ReferenceEquals(c.Store.WriteSyncObject, item.WriteSyncObject)));
+                        while (saveRequests.TryDequeue(out var requested))
+                            pending.Add(requested);
+
+                        var delay = Math.Max(0, SelfConfig.ConfigSaveDelay_) * Stopwatch.Frequency / 1000;
+                        var now = Stopwatch.GetTimestamp();
+                        var nextDue = long.MaxValue;
+
+                        for (var i = pending.Count - 1; i >= 0; i--)
+                        {
+                            var config = pending[i];
+                            var due = Math.Min(Volatile.Read(ref config.LastSaveRequestTicks) + delay,
+                                               config.FirstSaveRequestTicks + delay * MaxSaveDelayFactor);
+                            if (due > now)
+                            {
+                                nextDue = Math.Min(nextDue, due);
+                                continue;
+                            }
+
+                            pending[i] = pending[pending.Count - 1];
+                            pending.RemoveAt(pending.Count - 1);
+                            // clear this first, so that changes made while we write schedule another save
+                            Volatile.Write(ref config.SavePending, 0);
+                            Save(config);
+                        }
+
+                        var timeout = nextDue == long.MaxValue
+                            ? Timeout.Infinite
+                            : (int)Math.Min(int.MaxValue, Math.Max(1, (nextDue - now) * 1000 / Stopwatch.Frequency));
+                        _ = saveRequested.WaitOne(timeout);
                     }
                     catch (ThreadAbortException)
                     {
@@ -289,7 +275,7 @@ namespace IPA.Config
                     }
 
                     // otherwise, we have a thing that changed in a store
-                    Save(configArr[index - 1]);
+                    RequestSave(configArr[index - 1]);
                 }
             }
             catch (ThreadAbortException)
@@ -1,5 +1,6 @@
 ﻿using System;
 using System.IO;
+using System.Security.Cryptography;
 using System.Threading.Tasks;
 using IPA.Config.Data;
 
@@ -35,6 +36,10 @@ namespace IPA.Config
         /// <summary>
         /// Stores the <see cref="Value"/> given to disk in the format specified.
         /// </summary>
+        /// <remarks>
+        /// The file may be read by other threads or processes at any time, so implementations should write to a temporary
+        /// file and then replace <paramref name="file"/> with it, rather than writing it in place.
+        /// </remarks>
         /// <param name="value">the <see cref="Value"/> to store</param>
         /// <param name="file">the file to write to</param>
         void Store(Value value, FileInfo file);
@@ -61,11 +66,55 @@ namespace IPA.Config
             this.file = file; this.provider = provider;
         }
 
+        // the hash of the content last written by Store, used to tell our own writes apart from external changes
+        private volatile string lastWrittenHash;
+
         /// <summary>
         /// Stores the <see cref="Value"/> given to disk in the format specified.
         /// </summary>
         /// <param name="value">the <see cref="Value"/> to store</param>
-        public void Store(Value value) => provider.Store(value, file);
+        public void Store(Value value)
+        {
+            provider.Store(value, file);
+
+            try
+            {
+                lastWrittenHash = HashFile(file.FullName);
+            }
+            catch (Exception e) when (e is IOException or UnauthorizedAccessException)
+            { // the provider chose not to write anything, or the file is already being changed again
+                lastWrittenHash = null;
+            }
+        }
+
+        /// <summary>
+        /// Checks whether the file on disk is exactly what was last written by <see cref="Store(Value)"/>.
+        /// </summary>
+        internal bool IsUnchangedSinceStore()
+        {
+            var hash = lastWrittenHash;
+            if (hash == null) return false;
+
+            try
+            {
+                return HashFile(file.FullName) == hash;
+            }
+            catch (IOException)
+            { // either it doesn't exist, or someone else is writing it; both are external changes
+                return false;
+            }
+            catch (UnauthorizedAccessException)
+            {
+                return false;
+            }
+        }
+
+        private static string HashFile(string path)
+        {
+            using var sha = SHA256.Create();
+            using var stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.ReadWrite | FileShare.Delete);
+            return Convert.ToBase64String(sha.ComputeHash(stream));
+        }
         /// <summary>
         /// Loads a <see cref="Value"/> from disk in whatever format this provider provides
         /// and returns it.
@@ -1,37 +1,66 @@
 ﻿using System;
+using System.Collections.Generic;
 using System.IO;
-using System.Runtime.InteropServices;
 using System.Text;
+using System.Threading;
+using Logger = IPA.Logging.Logger;
 
 namespace IPA.Config
 {
     /// <summary>
     /// Create a New INI file to store or load data
     /// </summary>
-    [Obsolete("Jesus, this uses old 16-bit system calls!")]
+    /// <remarks>
+    /// <para>
+    /// This follows the rules of the Win32 private profile API that it used to call: section and key names are case
+    /// insensitive, the first of any duplicate keys wins, values are trimmed and may be quoted, and lines starting with
+    /// <c>;</c> are comments. New keys go at the end of their section, and new sections at the end of the file.
+    /// </para>
+    /// <para>
+    /// The file is parsed once into an index, and reads are served from memory. Writes only touch the affected line,
+    /// and the file is written back (atomically) once it stops changing, and when the game closes. Like <see cref="Config"/>
+    /// saves, a file that keeps changing is still written at most <see cref="ConfigRuntime.MaxSaveDelayFactor"/> save delays
+    /// after its first change. Pending writes are flushed by <see cref="ConfigRuntime.ShutdownRuntime()"/> when the game
+    /// closes. External changes are picked up by the same watcher that handles <see cref="Config"/> files, and any writes
+    /// that are still pending are applied on top of them.
+    /// </para>
+    /// <para>
+    /// There is only ever one instance per file, which is shared by everything that opens it with <see cref="Open(string)"/>.
+    /// </para>
+    /// </remarks>
     internal class IniFile
     {
-        [DllImport("KERNEL32.DLL", EntryPoint = "GetPrivateProfileStringW",
-        SetLastError = true,
-        CharSet = CharSet.Unicode, ExactSpelling = true,
-        CallingConvention = CallingConvention.StdCall)]
-        private static extern int GetPrivateProfileString(
-          string lpSection,
-          string lpKey,
-          string lpDefault,
-          StringBuilder lpReturnString,
-          int nSize,
-          string lpFileName);
-
-        [DllImport("KERNEL32.DLL", EntryPoint = "WritePrivateProfileStringW",
-          SetLastError = true,
-          CharSet = CharSet.Unicode, ExactSpelling = true,
-          CallingConvention = CallingConvention.StdCall)]
-        private static extern int WritePrivateProfileString(
-          string lpSection,
-          string lpKey,
-          string lpValue,
-          string lpFileName);
+        private sealed class Entry
+        {
+            public int Line;
+            public string Value;
+
+            public Entry(int line, string value)
+            {
+                Line = line;
+                Value = value;
+            }
+        }
+
+        private sealed class Section
+        {
+            public int LastLine; // the last non-blank line in the section, which new keys go after
+            public readonly Dictionary<string, Entry> Keys = new(StringComparer.OrdinalIgnoreCase);
+        }
+
+        // canonical path -> the one instance for that file
+        private static readonly Dictionary<string, IniFile> openFiles = new(ConfigFileWatcher.PathComparer);
+
+        private readonly object fileLock = new();
+        private List<string> lines = new();
+        private Dictionary<string, Section> sections = new(StringComparer.OrdinalIgnoreCase);
+        private Encoding encoding = Encoding.Default; // what the profile API used for files without a BOM
+        private string lastWritten;
+        private bool dirty;
+        private int firstDirtyTicks;
+        // the writes made since the last flush, so that they can be reapplied over an external change
+        private readonly List<(string Section, string Key, string Value)> pendingWrites = new();
+        private readonly Timer flushTimer;
 
         /*private string _path = "";
         public string Path
@@ -51,11 +80,44 @@ namespace IPA.Config
         private FileInfo _iniFileInfo;
         public FileInfo IniFileInfo {
             get => _iniFileInfo;
-            set { 
+            set {
                 _iniFileInfo = value;
                 if (_iniFileInfo.Exists) return;
                 _iniFileInfo.Directory?.Create();
-                _iniFileInfo.Create();
+                _iniFileInfo.Create().Dispose();
+            }
+        }
+
+        static IniFile()
+        {
+            AppDomain.CurrentDomain.ProcessExit += (_, _) => FlushAll();
+        }
+
+        /// <summary>
+        /// Writes the pending changes of every open file to disk.
+        /// </summary>
+        internal static void FlushAll()
+        {
+            lock (openFiles)
+            {
+                foreach (var file in openFiles.Values)
+                    file.Flush();
+            }
+        }
+
+        /// <summary>
+        /// Gets the <see cref="IniFile"/> for the file at <paramref name="iniPath"/>, opening it if it isn't already.
+        /// </summary>
+        /// <param name="iniPath">the path of the file</param>
+        /// <returns>the shared instance for that file</returns>
+        public static IniFile Open(string iniPath)
+        {
+            var fullPath = Path.GetFullPath(iniPath);
+            lock (openFiles)
+            {
+                if (!openFiles.TryGetValue(fullPath, out var file))
+                    openFiles.Add(fullPath, file = new IniFile(fullPath));
+                return file;
             }
         }
 
@@ -63,10 +125,15 @@ namespace IPA.Config
         /// INIFile Constructor.
         /// </summary>
         /// <PARAM name="iniPath"></PARAM>
-        public IniFile(string iniPath)
+        private IniFile(string iniPath)
         {
             IniFileInfo = new FileInfo(iniPath);
             //this.Path = INIPath;
+
+            flushTimer = new Timer(_ => Flush(), null, Timeout.Infinite, Timeout.Infinite);
+            Reload(force: true);
+
+            ConfigFileWatcher.Watch(IniFileInfo, () => Reload(force: false));
         }
 
         /// <summary>
@@ -80,7 +147,41 @@ namespace IPA.Config
         /// Value Name
         public void IniWriteValue(string section, string key, string value)
         {
-            WritePrivateProfileString(section, key, value, IniFileInfo.FullName);
+            lock (fileLock)
+            {
+                if (!Apply(section, key, value)) return;
+                pendingWrites.Add((section, key, value));
+                MarkDirty();
+            }
+        }
+
+        // returns whether anything changed
+        private bool Apply(string section, string key, string value)
+        {
+            if (value == null)
+                return RemoveKey(section, key);
+
+            if (sections.TryGetValue(section, out var sect) && sect.Keys.TryGetValue(key, out var entry))
+            {
+                if (entry.Value == value) return false;
+                lines[entry.Line] = $"{key}={value}";
+                entry.Value = value;
+                return true;
+            }
+
+            if (sect == null)
+            {
+                if (lines.Count > 0 && lines[lines.Count - 1].Trim().Length > 0)
+                    lines.Add("");
+                lines.Add($"[{section}]");
+                lines.Add($"{key}={value}");
+            }
+            else
+            {
+                lines.Insert(sect.LastLine + 1, $"{key}={value}");
+            }
+            Reindex();
+            return true;
         }
 
         /// <summary>
@@ -91,10 +192,144 @@ namespace IPA.Config
         /// <returns></returns>
         public string IniReadValue(string section, string key)
         {
-            const int maxChars = 1023;
-            StringBuilder result = new StringBuilder(maxChars);
-            GetPrivateProfileString(section, key, "", result, maxChars, IniFileInfo.FullName);
-            return result.ToString();
+            lock (fileLock)
+            {
+                return sections.TryGetValue(section, out var sect) && sect.Keys.TryGetValue(key, out var entry)
+                    ? entry.Value
+                    : "";
+            }
+        }
+
+        private bool RemoveKey(string section, string key)
+        {
+            if (!sections.TryGetValue(section, out var sect) || !sect.Keys.TryGetValue(key, out var entry))
+                return false;
+            lines.RemoveAt(entry.Line);
+            Reindex();
+            return true;
+        }
+
+        private void MarkDirty()
+        {
+            var now = Environment.TickCount;
+            if (!dirty)
+            {
+                dirty = true;
+                firstDirtyTicks = now;
+            }
+
+            // keep pushing the write back while it changes, but not forever
+            var delay = Math.Max(0, SelfConfig.ConfigSaveDelay_);
+            var latest = delay * ConfigRuntime.MaxSaveDelayFactor - unchecked(now - firstDirtyTicks);
+            _ = flushTimer.Change(Math.Max(0, Math.Min(delay, latest)), Timeout.Infinite);
+        }
+
+        private void Reindex()
+        {
+            var newSections = new Dictionary<string, Section>(StringComparer.OrdinalIgnoreCase);
+            Section current = null;
+
+            for (var i = 0; i < lines.Count; i++)
+            {
+                var line = lines[i].Trim();
+                if (line.Length == 0) continue;
+
+                if (line[0] == '[')
+                {
+                    var end = line.IndexOf(']');
+                    var name = (end < 0 ? line.Substring(1) : line.Substring(1, end - 1)).Trim();
+                    if (!newSections.TryGetValue(name, out current))
+                        newSections.Add(name, current = new Section());
+                    current.LastLine = i;
+                    continue;
+                }
+
+                if (current == null) continue; // keys before any section are ignored
+                current.LastLine = i;
+
+                if (line[0] == ';') continue;
+                var eq = line.IndexOf('=');
+                if (eq < 0) continue;
+
+                var key = line.Substring(0, eq).Trim();
+                if (!current.Keys.ContainsKey(key)) // the first duplicate wins
+                    current.Keys.Add(key, new Entry(i, Unquote(line.Substring(eq + 1).Trim())));
+            }
+
+            sections = newSections;
+        }
+
+        private static string Unquote(string value)
+            => value.Length >= 2 && (value[0] == '"' || value[0] == '\'') && value[value.Length - 1] == value[0]
+                ? value.Substring(1, value.Length - 2)
+                : value;
+
+        internal void Reload(bool force)
+        {
+            try
+            {
+                string text;
+                Encoding detected;
+                using (var reader = new StreamReader(IniFileInfo.FullName, encoding, true))
+                {
+                    text = reader.ReadToEnd();
+                    detected = reader.CurrentEncoding;
+                }
+
+                lock (fileLock)
+                {
+                    if (!force && text == lastWritten)
+                        return; // our own write
+
+                    encoding = detected;
+                    lastWritten = text;
+                    lines = new List<string>(text.Split(new[] { "\r\n", "\n" }, StringSplitOptions.None));
+                    if (lines.Count > 0 && lines[lines.Count - 1].Length == 0)
+                        lines.RemoveAt(lines.Count - 1); // the file's trailing newline
+                    Reindex();
+
+                    // keep the external change, with our own unwritten changes on top of it
+                    foreach (var (section, key, value) in pendingWrites)
+                        _ = Apply(section, key, value);
+                }
+            }
+            catch (Exception e) when (e is IOException or UnauthorizedAccessException)
+            {
+                Logger.Config.Warn($"Could not read {IniFileInfo.FullName}");
+                Logger.Config.Warn(e);
+            }
+        }
+
+        /// <summary>
+        /// Writes any pending changes to disk.
+        /// </summary>
+        public void Flush()
+        {
+            lock (fileLock)
+            {
+                if (!dirty) return;
+
+                var text = lines.Count == 0 ? "" : string.Join("\r\n", lines) + "\r\n";
+                var path = IniFileInfo.FullName;
+                var temp = path + ".tmp";
+                try
+                {
+                    File.WriteAllText(temp, text, encoding);
+                    if (File.Exists(path))
+                        File.Replace(temp, path, null, true);
+                    else
+                        File.Move(temp, path);
+
+                    lastWritten = text;
+                    dirty = false;
+                    pendingWrites.Clear();
+                }
+                catch (Exception e) when (e is IOException or UnauthorizedAccessException)
+                {
+                    Logger.Config.Error($"Could not write {path}");
+                    Logger.Config.Error(e);
+                }
+            }
         }
     }
 }
@@ -8,7 +8,7 @@ namespace IPA.Config
     /// <summary>
     /// Allows to get and set preferences for your mod.
     /// </summary>
-    [Obsolete("Uses IniFile, which uses 16 bit system calls. Use the new object based config system.")]
+    [Obsolete("Use the new object based config system.")]
     public interface IModPrefs
     {
         /// <summary>
@@ -88,7 +88,7 @@ namespace IPA.Config
     /// <summary>
     /// Allows to get and set preferences for your mod.
     /// </summary>
-    [Obsolete("Uses IniFile, which uses 16 bit system calls. Use BS Utils INI system for now.")]
+    [Obsolete("Use the new object based config system.")]
     public class ModPrefs : IModPrefs
     {
         private static ModPrefs _staticInstance;
@@ -101,13 +101,13 @@ namespace IPA.Config
         /// </summary>
         /// <param name="plugin">the plugin to get the preferences file for</param>
         public ModPrefs(PluginMetadata plugin) {
-            _instance = new IniFile(Path.Combine(Environment.CurrentDirectory, "UserData", "ModPrefs",
+            _instance = IniFile.Open(Path.Combine(Environment.CurrentDirectory, "UserData", "ModPrefs",
                 $"{plugin.Name}.ini"));
         }
 
         private ModPrefs()
         {
-            _instance = new IniFile(Path.Combine(Environment.CurrentDirectory, "UserData", "modprefs.ini"));
+            _instance = IniFile.Open(Path.Combine(Environment.CurrentDirectory, "UserData", "modprefs.ini"));
         }
 
         string IModPrefs.GetString(string section, string name, string defaultValue, bool autoSave)
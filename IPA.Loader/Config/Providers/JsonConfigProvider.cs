@@ -1,15 +1,9 @@
 ﻿using IPA.Config.Data;
 using IPA.Logging;
 using Newtonsoft.Json;
-using Newtonsoft.Json.Linq;
 using System;
-using System.Linq;
-using System.Collections.Specialized;
-using System.ComponentModel;
 using System.IO;
-using System.Collections.Generic;
 using Boolean = IPA.Config.Data.Boolean;
-using System.Threading.Tasks;
 
 namespace IPA.Config.Providers
 {
@@ -28,14 +22,17 @@ namespace IPA.Config.Providers
 
             try
             {
-                JToken jtok;
-                using (var sreader = new StreamReader(file.OpenRead()))
+                using var sreader = new StreamReader(file.OpenRead());
+                using var jreader = new JsonTextReader(sreader)
                 {
-                    using var jreader = new JsonTextReader(sreader);
-                    jtok = JToken.ReadFrom(jreader);
-                }
+                    DateParseHandling = DateParseHandling.None, // keep date-like strings as they were written
+                    FloatParseHandling = FloatParseHandling.Decimal,
+                };
+
+                if (!ReadSkippingComments(jreader))
+                    throw new JsonReaderException("File contained no JSON value");
 
-                return VisitToValue(jtok);
+                return ReadValue(jreader);
             }
             catch (Exception e)
             {
@@ -45,73 +42,81 @@ namespace IPA.Config.Providers
             }
         }
 
-        private Value VisitToValue(JToken tok)
+        private static bool ReadSkippingComments(JsonReader reader)
         {
-            if (tok == null) return Value.Null();
+            while (reader.Read())
+            {
+                if (reader.TokenType != JsonToken.Comment)
+                    return true;
+            }
+            return false;
+        }
 
-            switch (tok.Type)
+        // reads the value starting at the reader's current token, leaving the reader on its last token
+        private static Value ReadValue(JsonReader reader)
+        {
+            switch (reader.TokenType)
             {
-                case JTokenType.Raw: // idk if the parser will normally emit a Raw type, but just to be safe
-                    return VisitToValue(JToken.Parse((tok as JRaw).Value as string));
-                case JTokenType.Undefined:
-                    Logger.Config.Warn("Found JTokenType.Undefined");
-                    goto case JTokenType.Null;
-                case JTokenType.Bytes: // never used by Newtonsoft
-                    Logger.Config.Warn("Found JTokenType.Bytes");
-                    goto case JTokenType.Null;
-                case JTokenType.Comment: // never used by Newtonsoft
-                    Logger.Config.Warn("Found JTokenType.Comment");
-                    goto case JTokenType.Null;
-                case JTokenType.Constructor: // never used by Newtonsoft
-                    Logger.Config.Warn("Found JTokenType.Constructor");
-                    goto case JTokenType.Null;
-                case JTokenType.Property: // never used by Newtonsoft
-                    Logger.Config.Warn("Found JTokenType.Property");
-                    goto case JTokenType.Null;
-                case JTokenType.Null: 
+                case JsonToken.StartObject:
+                    var map = Value.Map();
+                    while (ReadSkippingComments(reader) && reader.TokenType != JsonToken.EndObject)
+                    {
+                        if (reader.TokenType != JsonToken.PropertyName)
+                            throw new JsonReaderException($"Unexpected token {reader.TokenType} in object at {reader.Path}");
+
+                        var key = (string)reader.Value;
+                        if (!ReadSkippingComments(reader))
+                            throw new JsonReaderException($"Unexpected end of file at {reader.Path}");
+
+                        var value = ReadValue(reader);
+                        if (map.ContainsKey(key))
+                            map[key] = value; // later duplicates replace earlier ones
+                        else
+                            map.Add(key, value);
+                    }
+                    return map;
+                case JsonToken.StartArray:
+                    var list = Value.List();
+                    while (ReadSkippingComments(reader) && reader.TokenType != JsonToken.EndArray)
+                        list.Add(ReadValue(reader));
+                    return list;
+                case JsonToken.Undefined:
+                    Logger.Config.Warn("Found JsonToken.Undefined");
+                    goto case JsonToken.Null;
+                case JsonToken.Bytes: // never used by the text reader
+                    Logger.Config.Warn("Found JsonToken.Bytes");
+                    goto case JsonToken.Null;
+                case JsonToken.StartConstructor: // never used by Newtonsoft
+                    Logger.Config.Warn("Found JsonToken.StartConstructor");
+                    reader.Skip();
+                    goto case JsonToken.Null;
+                case JsonToken.Null:
                     return Value.Null();
-                case JTokenType.Boolean:
-                    return Value.Bool(((tok as JValue).Value as bool?) ?? false);
-                case JTokenType.String:
-                    var val = (tok as JValue).Value;
+                case JsonToken.Boolean:
+                    return Value.Bool((reader.Value as bool?) ?? false);
+                case JsonToken.String:
+                    var val = reader.Value;
                     if (val is string s) return Value.Text(s);
                     else if (val is char c) return Value.Text("" + c);
                     else return Value.Text(string.Empty);
-                case JTokenType.Integer:
-                    val = (tok as JValue).Value;
+                case JsonToken.Integer:
+                    val = reader.Value;
                     if (val is long l) return Value.Integer(l);
                     else if (val is ulong u) return Value.Integer((long)u);
                     else return Value.Integer(0);
-                case JTokenType.Float:
-                    val = (tok as JValue).Value;
+                case JsonToken.Float:
+                    val = reader.Value;
                     if (val is decimal dec) return Value.Float(dec);
                     else if (val is double dou) return Value.Float((decimal)dou);
                     else if (val is float flo) return Value.Float((decimal)flo);
                     else return Value.Float(0); // default to 0 if something breaks
-                case JTokenType.Date:
-                    val = (tok as JValue).Value;
+                case JsonToken.Date:
+                    val = reader.Value;
                     if (val is DateTime dt) return Value.Text(dt.ToString());
                     else if (val is DateTimeOffset dto) return Value.Text(dto.ToString());
                     else return Value.Text("Unknown Date-type token");
-                case JTokenType.TimeSpan:
-                    val = (tok as JValue).Value;
-                    if (val is TimeSpan ts) return Value.Text(ts.ToString());
-                    else return Value.Text("Unknown TimeSpan-type token");
-                case JTokenType.Guid:
-                    val = (tok as JValue).Value;
-                    if (val is Guid g) return Value.Text(g.ToString());
-                    else return Value.Text("Unknown Guid-type token");
-                case JTokenType.Uri:
-                    val = (tok as JValue).Value;
-                    if (val is Uri ur) return Value.Text(ur.ToString());
-                    else return Value.Text("Unknown Uri-type token");
-                case JTokenType.Array:
-                    return Value.From((tok as JArray).Select(VisitToValue));
-                case JTokenType.Object:
-                    return Value.From((tok as IEnumerable<KeyValuePair<string, JToken>>)
-                        .Select(kvp => new KeyValuePair<string, Value>(kvp.Key, VisitToValue(kvp.Value))));
                 default:
-                    throw new ArgumentException($"Unknown {nameof(JTokenType)} in parameter");
+                    throw new JsonReaderException($"Unexpected token {reader.TokenType} at {reader.Path}");
             }
         }
 
@@ -120,46 +125,66 @@ namespace IPA.Config.Providers
             if (!file.Directory.Exists)
                 file.Directory.Create();
 
+            // write to a temporary file, then replace the real one with it, so that readers never see a partially written file
+            var temp = new FileInfo(file.FullName + ".tmp");
             try
             {
-                var tok = VisitToToken(value);
+                using (var swriter = new StreamWriter(temp.Open(FileMode.Create, FileAccess.Write)))
+                using (var jwriter = new JsonTextWriter(swriter) { Formatting = Formatting.Indented })
+                    WriteValue(jwriter, value);
 
-                using var swriter = new StreamWriter(file.Open(FileMode.Create, FileAccess.Write));
-                using var jwriter = new JsonTextWriter(swriter)
-                {
-                    Formatting = Formatting.Indented
-                };
-                tok.WriteTo(jwriter);
+                if (File.Exists(file.FullName))
+                    File.Replace(temp.FullName, file.FullName, null, true);
+                else
+                    File.Move(temp.FullName, file.FullName);
             }
-            catch (Exception e)
-            {
-                Logger.Config.Error($"Error serializing value for {file.FullName}");
-                Logger.Config.Error(e);
+            catch
+            { // errors propagate, so that a partially written file never replaces the existing one
+                try
+                {
+                    temp.Delete();
+                }
+                catch (IOException)
+                {
+                }
+                throw;
             }
         }
 
-        private JToken VisitToToken(Value val) 
-        { 
+        private static void WriteValue(JsonWriter writer, Value val)
+        {
             switch (val)
             {
                 case Text t:
-                    return new JValue(t.Value);
+                    writer.WriteValue(t.Value);
+                    break;
                 case Boolean b:
-                    return new JValue(b.Value);
+                    writer.WriteValue(b.Value);
+                    break;
                 case Integer i:
-                    return new JValue(i.Value);
+                    writer.WriteValue(i.Value);
+                    break;
                 case FloatingPoint f:
-                    return new JValue(f.Value);
+                    writer.WriteValue(f.Value);
+                    break;
                 case List l:
-                    var jarr = new JArray();
-                    foreach (var tok in l.Select(VisitToToken)) jarr.Add(tok);
-                    return jarr;
+                    writer.WriteStartArray();
+                    foreach (var item in l)
+                        WriteValue(writer, item);
+                    writer.WriteEndArray();
+                    break;
                 case Map m:
-                    var jobj = new JObject();
-                    foreach (var kvp in m) jobj.Add(kvp.Key, VisitToToken(kvp.Value));
-                    return jobj;
+                    writer.WriteStartObject();
+                    foreach (var kvp in m)
+                    {
+                        writer.WritePropertyName(kvp.Key);
+                        WriteValue(writer, kvp.Value);
+                    }
+                    writer.WriteEndObject();
+                    break;
                 case null:
-                    return JValue.CreateNull();
+                    writer.WriteNull();
+                    break;
                 default:
                     throw new ArgumentException($"Unsupported subtype of {nameof(Value)}");
             }
@@ -51,7 +51,7 @@ namespace IPA.Config
         internal const string IPAVersion = "4.3.7.0";
 
         // uses Updates.AutoUpdate, Updates.AutoCheckUpdates, YeetMods, Debug.ShowCallSource, Debug.ShowDebug,
-        //      Debug.CondenseModLogs
+        //      Debug.CondenseModLogs, Debug.ProfilePluginLoading
         internal static SelfConfig CommandLineValues = new();
 
         // For readability's sake, I want the default values to be visible in source.
@@ -108,14 +108,6 @@ namespace IPA.Config
             // LINE: ignore
             public static bool ShowHandledErrorStackTraces_ => Instance?.Debug?.ShowHandledErrorStackTraces ?? false;
 
-            public virtual bool HideMessagesForPerformance { get; set; } = true;
-            // LINE: ignore
-            public static bool HideMessagesForPerformance_ => Instance?.Debug?.HideMessagesForPerformance ?? true;
-
-            public virtual int HideLogThreshold { get; set; } = 512;
-            // LINE: ignore
-            public static int HideLogThreshold_ => Instance?.Debug?.HideLogThreshold ?? 512;
-
             public virtual bool ShowTrace { get; set; } = false;
             // LINE: ignore 2
             public static bool ShowTrace_ => (Instance?.Debug?.ShowTrace ?? false)
@@ -128,6 +120,11 @@ namespace IPA.Config
             // LINE: ignore 2
             public static bool DarkenMessages_ => (Instance?.Debug?.DarkenMessages ?? false)
                                                || CommandLineValues.Debug.DarkenMessages;
+
+            public virtual bool ProfilePluginLoading { get; set; } = false;
+            // LINE: ignore 2
+            public static bool ProfilePluginLoading_ => (Instance?.Debug?.ProfilePluginLoading ?? false)
+                                                     ||   CommandLineValues.Debug.ProfilePluginLoading;
         }
 
         // LINE: ignore
@@ -157,6 +154,10 @@ namespace IPA.Config
         [JsonIgnore]
         public bool WriteLogs { get; set; } = true;
 
+        public virtual int ConfigSaveDelay { get; set; } = 250;
+        // LINE: ignore
+        public static int ConfigSaveDelay_ => Instance?.ConfigSaveDelay ?? 250;
+
         public virtual bool ResetGameAssembliesOnVersionChange { get; set; } = true;
 
         // LINE: ignore
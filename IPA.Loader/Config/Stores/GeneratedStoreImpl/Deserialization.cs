@@ -51,7 +51,11 @@ namespace IPA.Config.Stores
         {
             if (typeof(Value).IsAssignableFrom(targetType)) return; // do nothing
 
-            if (expected == typeof(Text))
+            if (targetType.IsEnum)
+            {
+                il.Emit(OpCodes.Call, DeserializeEnumMethod.MakeGenericMethod(targetType));
+            }
+            else if (expected == typeof(Text))
             {
                 var getter = expected.GetProperty(nameof(Text.Value)).GetGetMethod();
                 il.Emit(OpCodes.Call, getter);
@@ -78,7 +82,12 @@ namespace IPA.Config.Stores
                 var getter = expected.GetProperty(nameof(FloatingPoint.Value)).GetGetMethod();
                 il.Emit(OpCodes.Call, getter);
                 EmitNumberConvertTo(il, targetType, getter.ReturnType);
-            } // TODO: implement stuff for lists and maps of various types (probably call out somewhere else to figure out what to do)
+            }
+            else if (expected == typeof(List) && TryGetDirectCollection(targetType, out _, out var deserializeCollection))
+            {
+                parentobj(il);
+                il.Emit(OpCodes.Call, deserializeCollection);
+            } // TODO: implement stuff for lists and maps of complex types (probably call out somewhere else to figure out what to do)
             else if (expected == typeof(Map))
             {
                 if (!targetType.IsValueType)
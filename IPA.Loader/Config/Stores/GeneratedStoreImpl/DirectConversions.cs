@@ -0,0 +1,162 @@
+﻿#nullable enable
+using IPA.Config.Data;
+using IPA.Config.Stores.Converters;
+using IPA.Logging;
+using System;
+using System.Collections.Generic;
+using System.Reflection;
+using Boolean = IPA.Config.Data.Boolean;
+
+namespace IPA.Config.Stores
+{
+    internal static partial class GeneratedStoreImpl
+    {
+        // these are called directly by generated code for members without a converter, so that enums and
+        // collections of simple values don't have to go through a boxed IValueConverter
+        #region Enums
+        private static readonly MethodInfo SerializeEnumMethod = typeof(GeneratedStoreImpl).GetMethod(nameof(SerializeEnum), BindingFlags.NonPublic | BindingFlags.Static);
+        internal static Value? SerializeEnum<T>(T value) where T : struct, Enum
+            => Value.Text(EnumNames<T>.Names.TryGetValue(value, out var name) ? name : value.ToString());
+
+        private static readonly MethodInfo DeserializeEnumMethod = typeof(GeneratedStoreImpl).GetMethod(nameof(DeserializeEnum), BindingFlags.NonPublic | BindingFlags.Static);
+        internal static T DeserializeEnum<T>(Value value) where T : struct, Enum
+        {
+            switch (value)
+            {
+                case Text text:
+                    return EnumNames<T>.Values.TryGetValue(text.Value, out var result)
+                        ? result
+                        : (T)Enum.Parse(typeof(T), text.Value, true); // flags combinations and numeric strings
+                case Integer integer:
+                    return (T)Enum.ToObject(typeof(T), integer.Value);
+                case Map map when map.TryGetValue("value__", out var backing) && backing is Integer legacy:
+                    // enums without a converter used to be serialized as a map of their backing field
+                    return (T)Enum.ToObject(typeof(T), legacy.Value);
+                default:
+                    throw new ArgumentException($"Cannot convert {value.GetType()} to {typeof(T)}", nameof(value));
+            }
+        }
+
+        private static class EnumNames<T> where T : struct, Enum
+        {
+            public static readonly Dictionary<T, string> Names = new();
+            public static readonly Dictionary<string, T> Values = new(StringComparer.OrdinalIgnoreCase);
+
+            static EnumNames()
+            {
+                foreach (var name in Enum.GetNames(typeof(T)))
+                {
+                    var value = (T)Enum.Parse(typeof(T), name);
+                    Values[name] = value;
+                    if (!Names.ContainsKey(value))
+                        Names.Add(value, value.ToString()); // matches what the enum converters write for aliased values
+                }
+            }
+        }
+        #endregion
+
+        #region Collections
+        private static bool IsDirectElementType(Type type)
+        {
+            if (type.IsEnum) return true;
+            if (typeof(Value).IsAssignableFrom(type)) return false;
+            var expected = GetExpectedValueTypeForType(type);
+            return expected == typeof(Text)
+                || expected == typeof(Boolean)
+                || expected == typeof(Integer)
+                || expected == typeof(FloatingPoint);
+        }
+
+        private static readonly Type[] directCollectionDefinitions =
+        {
+            typeof(List<>), typeof(IList<>), typeof(ICollection<>), typeof(IEnumerable<>),
+            typeof(IReadOnlyList<>), typeof(IReadOnlyCollection<>), typeof(HashSet<>), typeof(ISet<>),
+        };
+
+        /// <summary>
+        /// Gets the element type and deserializer for a collection of simple values that generated code can convert
+        /// without a converter, if <paramref name="type"/> is one.
+        /// </summary>
+        private static bool TryGetDirectCollection(Type type, out Type elementType, out MethodInfo deserialize)
+        {
+            elementType = null!;
+            deserialize = null!;
+
+            if (type.IsArray)
+            {
+                if (type.GetArrayRank() != 1) return false;
+                elementType = type.GetElementType();
+                deserialize = DeserializeArrayMethod;
+            }
+            else if (type.IsGenericType && Array.IndexOf(directCollectionDefinitions, type.GetGenericTypeDefinition()) >= 0)
+            {
+                elementType = type.GetGenericArguments()[0];
+                deserialize = type.IsAssignableFrom(typeof(List<>).MakeGenericType(elementType))
+                    ? DeserializeListMethod
+                    : DeserializeHashSetMethod;
+            }
+            else
+                return false;
+
+            if (!IsDirectElementType(elementType)) return false;
+            deserialize = deserialize.MakeGenericMethod(elementType);
+            return true;
+        }
+
+        private static readonly MethodInfo SerializeCollectionMethod = typeof(GeneratedStoreImpl).GetMethod(nameof(SerializeCollection), BindingFlags.NonPublic | BindingFlags.Static);
+        internal static List SerializeCollection<T>(IEnumerable<T?> items, object parent)
+        {
+            var converter = Converter<T>.Default;
+            var list = Value.List();
+            if (items is IList<T?> indexable)
+            {
+                for (var i = 0; i < indexable.Count; i++)
+                    list.Add(converter.ToValue(indexable[i], parent));
+            }
+            else
+            {
+                foreach (var item in items)
+                    list.Add(converter.ToValue(item, parent));
+            }
+            return list;
+        }
+
+        private static void PopulateCollection<T>(ICollection<T?> target, List list, object parent)
+        {
+            var converter = Converter<T>.Default;
+            foreach (var value in list)
+            {
+                try
+                {
+                    target.Add(converter.FromValue(value, parent));
+                }
+                catch (Exception e)
+                { // drop just the bad element, like a bad member is dropped
+                    Logger.Config.Warn($"Skipping invalid {typeof(T)} collection element {value}");
+                    Logger.Config.Warn(e);
+                }
+            }
+        }
+
+        private static readonly MethodInfo DeserializeListMethod = typeof(GeneratedStoreImpl).GetMethod(nameof(DeserializeList), BindingFlags.NonPublic | BindingFlags.Static);
+        internal static List<T?> DeserializeList<T>(List list, object parent)
+        {
+            var result = new List<T?>(list.Count);
+            PopulateCollection(result, list, parent);
+            return result;
+        }
+
+        private static readonly MethodInfo DeserializeArrayMethod = typeof(GeneratedStoreImpl).GetMethod(nameof(DeserializeArray), BindingFlags.NonPublic | BindingFlags.Static);
+        internal static T?[] DeserializeArray<T>(List list, object parent)
+            => DeserializeList<T>(list, parent).ToArray();
+
+        private static readonly MethodInfo DeserializeHashSetMethod = typeof(GeneratedStoreImpl).GetMethod(nameof(DeserializeHashSet), BindingFlags.NonPublic | BindingFlags.Static);
+        internal static HashSet<T?> DeserializeHashSet<T>(List list, object parent)
+        {
+            var result = new HashSet<T?>();
+            PopulateCollection(result, list, parent);
+            return result;
+        }
+        #endregion
+    }
+}
@@ -4,6 +4,7 @@ using IPA.Utilities;
 using IPA.Utilities.Async;
 using System;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Linq;
 using System.Reflection;
 using System.Reflection.Emit;
@@ -30,7 +31,25 @@ namespace IPA.Config.Stores
         private static readonly SingleCreationValueCache<Type, (GeneratedStoreCreator ctor, Type type)> generatedCreators = new();
 
         private static (GeneratedStoreCreator ctor, Type type) GetCreatorAndGeneratedType(Type t)
-            => generatedCreators.GetOrAdd(t, MakeCreator);
+            => generatedCreators.GetOrAdd(t, LoadOrMakeCreator);
+
+        private static (GeneratedStoreCreator ctor, Type type) LoadOrMakeCreator(Type t)
+        {
+            var timer = Stopwatch.StartNew();
+            if (StoreCache.TryLoad(t, out var cached, out var generateMs))
+            {
+                var creator = MakeCreatorFor(cached);
+                Logger.Config.Debug("Loaded cached store for {0} in {1:F1}ms (generating it took {2:F1}ms)",
+                    t, timer.Elapsed.TotalMilliseconds, generateMs);
+                return (creator, cached);
+            }
+
+            var result = MakeCreator(t);
+            var elapsedMs = timer.Elapsed.TotalMilliseconds;
+            StoreCache.Record(t, result.type, elapsedMs);
+            Logger.Config.Debug("Generated store for {0} in {1:F1}ms", t, elapsedMs);
+            return result;
+        }
 
         internal static GeneratedStoreCreator GetCreator(Type t)
             => GetCreatorAndGeneratedType(t).ctor;
@@ -48,25 +67,13 @@ namespace IPA.Config.Stores
                 if (assembly == null)
                 {
                     var name = new AssemblyName(GeneratedAssemblyName);
-                    assembly = AppDomain.CurrentDomain.DefineDynamicAssembly(name, AssemblyBuilderAccess.RunAndSave);
+                    assembly = AppDomain.CurrentDomain.DefineDynamicAssembly(name, AssemblyBuilderAccess.RunAndSave, StoreCache.GenerationDirectory);
                 }
 
                 return assembly;
             }
         }
 
-        internal static void DebugSaveAssembly(string file)
-        {
-            try
-            {
-                Assembly.Save(file);
-            }
-            catch (Exception ex)
-            {
-                Logger.Config.Error(ex);
-            }
-        }
-
         private static ModuleBuilder? module;
         private static ModuleBuilder Module
         {
@@ -78,13 +78,40 @@ namespace IPA.Config.Stores
                     WriteSyncObject.ExitReadLock();
             }
 
+            // a seqlock over the write lock: odd while a writer is modifying the store, so that simple property reads
+            // can skip the read lock, and retry under it only if a write overlapped them
+            private int writeVersion;
+
+            internal static MethodInfo ImplBeginOptimisticReadMethod = typeof(Impl).GetMethod(nameof(ImplBeginOptimisticRead));
+            public static int ImplBeginOptimisticRead(IGeneratedStore s) => FindImpl(s)?.BeginOptimisticRead() ?? 0;
+            public int BeginOptimisticRead() => Volatile.Read(ref writeVersion);
+
+            internal static MethodInfo ImplValidateOptimisticReadMethod = typeof(Impl).GetMethod(nameof(ImplValidateOptimisticRead));
+            public static bool ImplValidateOptimisticRead(IGeneratedStore s, int version) => FindImpl(s)?.ValidateOptimisticRead(version) ?? true;
+            public bool ValidateOptimisticRead(int version)
+            {
+                Interlocked.MemoryBarrier(); // don't let the value read move after the version read
+                return (version & 1) == 0 && Volatile.Read(ref writeVersion) == version;
+            }
+
+            private void BeginWrite() => Interlocked.Increment(ref writeVersion);
+            private void EndWrite() => Interlocked.Increment(ref writeVersion);
+
             internal static MethodInfo ImplTakeWriteMethod = typeof(Impl).GetMethod(nameof(ImplTakeWrite));
             public static void ImplTakeWrite(IGeneratedStore s) => FindImpl(s)?.TakeWrite();
-            public void TakeWrite() => WriteSyncObject.EnterWriteLock();
+            public void TakeWrite()
+            {
+                WriteSyncObject.EnterWriteLock();
+                BeginWrite();
+            }
 
             internal static MethodInfo ImplReleaseWriteMethod = typeof(Impl).GetMethod(nameof(ImplReleaseWrite));
             public static void ImplReleaseWrite(IGeneratedStore s) => FindImpl(s)?.ReleaseWrite();
-            public void ReleaseWrite() => WriteSyncObject.ExitWriteLock();
+            public void ReleaseWrite()
+            {
+                EndWrite();
+                WriteSyncObject.ExitWriteLock();
+            }
 
             internal static MethodInfo ImplChangeTransactionMethod = typeof(Impl).GetMethod(nameof(ImplChangeTransaction));
             public static IDisposable? ImplChangeTransaction(IGeneratedStore s, IDisposable nest) => FindImpl(s)?.ChangeTransaction(nest);
@@ -163,10 +190,20 @@ namespace IPA.Config.Stores
                 Logger.Config.Debug($"Generated impl ReadFrom {generated.GetType()}");
                 var values = provider.Load();
                 //Logger.config.Debug($"Read {values}");
-                generated.Deserialize(values);
 
-                using var transaction = generated.ChangeTransaction();
-                generated.OnReload();
+                // the caller holds the write lock, but took it directly, so optimistic readers need to be told
+                BeginWrite();
+                try
+                {
+                    generated.Deserialize(values);
+
+                    using var transaction = generated.ChangeTransaction();
+                    generated.OnReload();
+                }
+                finally
+                {
+                    EndWrite();
+                }
             }
 
             internal static MethodInfo ImplWriteToMethod = typeof(Impl).GetMethod(nameof(ImplWriteTo));
@@ -8,6 +8,7 @@ using System.Linq;
 using System.Linq.Expressions;
 using System.Reflection;
 using System.Reflection.Emit;
+using System.Runtime.CompilerServices;
 using System.Threading;
 
 namespace IPA.Config.Stores
@@ -647,6 +648,32 @@ namespace IPA.Config.Stores
 
                     var local = il.DeclareLocal(member.Type);
 
+                    // auto-properties just read a field, so they can be read optimistically, and only take the lock if
+                    // that raced with a write; anything else might not tolerate seeing a write in progress
+                    if (get.IsDefined(typeof(CompilerGeneratedAttribute), false))
+                    {
+                        var versionLocal = il.DeclareLocal(typeof(int));
+                        var lockedRead = il.DefineLabel();
+
+                        il.Emit(OpCodes.Ldarg_0);
+                        il.Emit(OpCodes.Call, Impl.ImplBeginOptimisticReadMethod);
+                        il.Emit(OpCodes.Stloc, versionLocal);
+
+                        il.Emit(OpCodes.Ldarg_0);
+                        il.Emit(OpCodes.Call, get); // call base getter
+                        il.Emit(OpCodes.Stloc, local);
+
+                        il.Emit(OpCodes.Ldarg_0);
+                        il.Emit(OpCodes.Ldloc, versionLocal);
+                        il.Emit(OpCodes.Call, Impl.ImplValidateOptimisticReadMethod);
+                        il.Emit(OpCodes.Brfalse, lockedRead);
+
+                        il.Emit(OpCodes.Ldloc, local);
+                        il.Emit(OpCodes.Ret);
+
+                        il.MarkLabel(lockedRead);
+                    }
+
                     il.Emit(OpCodes.Ldarg_0);
                     il.Emit(OpCodes.Call, Impl.ImplTakeReadMethod); // take the read lock
 
@@ -103,6 +103,10 @@ namespace IPA.Config.Stores
                 il.EndExceptionBlock();
                 il.Emit(OpCodes.Ldloc_1);
             }
+            else if (memberConversionType.IsEnum)
+            {
+                il.Emit(OpCodes.Call, SerializeEnumMethod.MakeGenericMethod(memberConversionType));
+            }
             else if (targetType == typeof(Text))
             { // only happens when arg is a string or char
                 var TextCreate = typeof(Value).GetMethod(nameof(Value.Text));
@@ -132,10 +136,18 @@ namespace IPA.Config.Stores
             }
             else if (targetType == typeof(List))
             {
-                // TODO: impl this (enumerables)
-                Logger.Config.Warn($"Implicit conversions to {targetType} are not currently implemented");
-                il.Emit(OpCodes.Pop);
-                il.Emit(OpCodes.Ldnull);
+                if (TryGetDirectCollection(memberConversionType, out var elementType, out _))
+                {
+                    il.Emit(OpCodes.Ldarg_0);
+                    il.Emit(OpCodes.Call, SerializeCollectionMethod.MakeGenericMethod(elementType));
+                }
+                else
+                {
+                    // TODO: impl this (enumerables of complex types)
+                    Logger.Config.Warn($"Implicit conversions to {targetType} are not currently implemented");
+                    il.Emit(OpCodes.Pop);
+                    il.Emit(OpCodes.Ldnull);
+                }
             }
             else if (targetType == typeof(Map))
             {
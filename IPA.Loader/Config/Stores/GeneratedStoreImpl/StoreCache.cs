@@ -0,0 +1,348 @@
+﻿#nullable enable
+using IPA.Config.Stores.Attributes;
+using IPA.Logging;
+using IPA.Utilities;
+using Newtonsoft.Json;
+using System;
+using System.Collections;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Linq.Expressions;
+using System.Reflection;
+
+namespace IPA.Config.Stores
+{
+    internal static partial class GeneratedStoreImpl
+    {
+        internal static void SaveCache() => StoreCache.Save();
+
+        private static GeneratedStoreCreator MakeCreatorFor(Type generated)
+        {
+            var ctor = generated.GetConstructor(new[] { typeof(IGeneratedStore) });
+            var parentParam = Expression.Parameter(typeof(IGeneratedStore), "parent");
+            return Expression.Lambda<GeneratedStoreCreator>(
+                Expression.New(ctor, parentParam), parentParam
+            ).Compile();
+        }
+
+        /// <summary>
+        /// Persists the generated store implementations across launches.
+        /// </summary>
+        /// <remarks>
+        /// <para>
+        /// A launch that generated all of its stores saves its dynamic assembly into its own directory when the game
+        /// closes, and records in a manifest which config types it holds, along with the MVIDs of every assembly that
+        /// went into generating them. That generation replaces any older one.
+        /// </para>
+        /// <para>
+        /// Later launches load the generated type straight from that assembly, as long as the MVID of BSIPA itself and all
+        /// of those MVIDs are unchanged. BSIPA's MVID is used rather than its version, so that a build that changes the
+        /// generator without bumping the version still doesn't load stale code. Every generation is named <see cref="GeneratedAssemblyName"/>, which the
+        /// <c>InternalsVisibleTo</c> attribute needs, so only one may ever be loaded in a launch. To keep it that way,
+        /// the manifest only ever refers to a single generation:
+        /// </para>
+        /// <list type="bullet">
+        /// <item>If a store is missing or stale before anything was loaded from the cache, the cache is not used at all
+        /// for the rest of the launch, and everything generated is saved as the new generation.</item>
+        /// <item>If that happens after some stores were already loaded from the cache, the generated assembly can't be
+        /// saved, because it would refer to types in the loaded one. The manifest is deleted instead, so that the next
+        /// launch regenerates everything into a single new generation.</item>
+        /// </list>
+        /// </remarks>
+        private static class StoreCache
+        {
+            private const string ManifestName = "manifest.json";
+
+            // the generator changes with every build of BSIPA, not just every release
+            private static readonly Guid GeneratorId = typeof(GeneratedStoreImpl).Assembly.ManifestModule.ModuleVersionId;
+
+            private sealed class Manifest
+            {
+                public Guid Generator;
+                public List<Entry> Entries = new();
+            }
+
+            private sealed class Entry
+            {
+                public string Type = "";
+                public string GeneratedType = "";
+                public string Directory = "";
+                public Dictionary<string, Guid> Assemblies = new();
+                public double GenerateMilliseconds;
+            }
+
+            public static string CacheDirectory => Path.Combine(UnityGame.UserDataPath, ".GeneratedStoreCache");
+
+            private static string? generationName;
+            // the directory this launch's dynamic assembly is saved to
+            public static string GenerationDirectory
+                => Path.Combine(CacheDirectory, generationName ??= DateTime.UtcNow.Ticks.ToString("x16", CultureInfo.InvariantCulture));
+
+            private static readonly object cacheLock = new();
+            private static Manifest? manifest;
+            private static Dictionary<string, Entry>? entriesByType;
+            private static string? loadedGenerationName;
+            private static Dictionary<string, Type>? loadedGeneration;
+            private static readonly List<Entry> generated = new();
+            private static bool saved;
+            private static bool cacheDisabled; // a store missed before anything was loaded from the cache
+            private static bool mixed; // a store missed after some were loaded from the cache
+
+            private static bool Miss()
+            {
+                if (loadedGeneration == null)
+                    cacheDisabled = true;
+                else
+                    mixed = true;
+                return false;
+            }
+
+            public static bool TryLoad(Type type, out Type generatedType, out double generateMilliseconds)
+            {
+                generatedType = null!;
+                generateMilliseconds = 0;
+
+                try
+                {
+                    lock (cacheLock)
+                    {
+                        if (cacheDisabled) return false;
+
+                        EnsureManifest();
+                        if (!entriesByType!.TryGetValue(type.AssemblyQualifiedName, out var entry))
+                            return Miss();
+
+                        if (!DependenciesMatch(CollectDependencies(type), entry.Assemblies))
+                        {
+                            Logger.Config.Debug<Type>("Cached generated store for {0} is stale", type);
+                            return Miss();
+                        }
+
+                        var types = LoadGeneration(entry.Directory);
+                        if (types == null || !types.TryGetValue(entry.GeneratedType, out generatedType))
+                            return Miss();
+
+                        generateMilliseconds = entry.GenerateMilliseconds;
+                        return true;
+                    }
+                }
+                catch (Exception e)
+                {
+                    Logger.Config.Warn($"Could not load cached generated store for {type}");
+                    Logger.Config.Warn(e);
+                    lock (cacheLock)
+                        return Miss();
+                }
+            }
+
+            public static void Record(Type type, Type generatedType, double generateMilliseconds)
+            {
+                try
+                {
+                    var entry = new Entry
+                    {
+                        Type = type.AssemblyQualifiedName,
+                        GeneratedType = generatedType.FullName,
+                        Assemblies = CollectDependencies(type),
+                        GenerateMilliseconds = generateMilliseconds,
+                    };
+
+                    lock (cacheLock)
+                    {
+                        if (saved) return; // the assembly has already been written, this one will be generated again next time
+                        generated.Add(entry);
+                    }
+                }
+                catch (Exception e)
+                {
+                    Logger.Config.Warn($"Could not record generated store for {type} for caching");
+                    Logger.Config.Warn(e);
+                }
+            }
+
+            public static void Save()
+            {
+                lock (cacheLock)
+                {
+                    if (saved || generated.Count == 0) return;
+                    saved = true;
+
+                    var manifestPath = Path.Combine(CacheDirectory, ManifestName);
+                    try
+                    {
+                        if (mixed)
+                        {
+                            Logger.Config.Debug("Some generated stores were stale; they will all be regenerated next launch");
+                            if (File.Exists(manifestPath))
+                                File.Delete(manifestPath);
+                            return;
+                        }
+
+                        var dir = GenerationDirectory;
+                        _ = Directory.CreateDirectory(dir);
+                        Assembly.Save(GeneratedAssemblyName + ".dll");
+
+                        var name = Path.GetFileName(dir);
+                        foreach (var entry in generated)
+                            entry.Directory = name;
+
+                        manifest = new()
+                        {
+                            Generator = GeneratorId,
+                            Entries = generated.ToList(),
+                        };
+
+                        var tempPath = manifestPath + ".tmp";
+                        File.WriteAllText(tempPath, JsonConvert.SerializeObject(manifest, Formatting.Indented));
+                        if (File.Exists(manifestPath))
+                            File.Replace(tempPath, manifestPath, null, true);
+                        else
+                            File.Move(tempPath, manifestPath);
+
+                        Prune(new HashSet<string>(manifest.Entries.Select(e => e.Directory)));
+                    }
+                    catch (Exception e)
+                    {
+                        Logger.Config.Warn("Could not save generated config stores");
+                        Logger.Config.Warn(e);
+                    }
+                }
+            }
+
+            private static void EnsureManifest()
+            {
+                if (manifest != null) return;
+
+                try
+                {
+                    var path = Path.Combine(CacheDirectory, ManifestName);
+                    if (File.Exists(path))
+                        manifest = JsonConvert.DeserializeObject<Manifest>(File.ReadAllText(path));
+                }
+                catch (Exception e)
+                {
+                    Logger.Config.Warn("Generated store cache manifest is invalid, ignoring it");
+                    Logger.Config.Warn(e);
+                }
+
+                // a different build of BSIPA means different generated code, so nothing is reusable,
+                // and a manifest that refers to more than one generation was not written by this version
+                if (manifest == null || manifest.Generator != GeneratorId
+                    || manifest.Entries.Select(e => e.Directory).Distinct().Count() > 1)
+                    manifest = new();
+
+                entriesByType = new();
+                foreach (var entry in manifest.Entries)
+                    entriesByType[entry.Type] = entry;
+            }
+
+            private static Dictionary<string, Type>? LoadGeneration(string name)
+            {
+                if (loadedGenerationName != null)
+                    return loadedGenerationName == name ? loadedGeneration : null;
+
+                loadedGenerationName = name;
+                try
+                {
+                    var asm = System.Reflection.Assembly.LoadFile(Path.Combine(CacheDirectory, name, GeneratedAssemblyName + ".dll"));
+                    loadedGeneration = asm.GetTypes().ToDictionary(t => t.FullName);
+                }
+                catch (Exception e)
+                {
+                    Logger.Config.Warn($"Could not load cached generated stores from {name}");
+                    Logger.Config.Warn(e);
+                    loadedGeneration = null;
+                }
+
+                return loadedGeneration;
+            }
+
+            private static void Prune(HashSet<string> referenced)
+            {
+                foreach (var dir in new DirectoryInfo(CacheDirectory).GetDirectories())
+                {
+                    if (referenced.Contains(dir.Name)) continue;
+
+                    try
+                    {
+                        dir.Delete(true);
+                    }
+                    catch (Exception e) when (e is IOException or UnauthorizedAccessException)
+                    { // probably loaded this launch, it'll go next time
+                    }
+                }
+            }
+
+            private static bool DependenciesMatch(Dictionary<string, Guid> current, Dictionary<string, Guid> cached)
+            {
+                if (current.Count != cached.Count) return false;
+                foreach (var kvp in current)
+                {
+                    if (!cached.TryGetValue(kvp.Key, out var mvid) || mvid != kvp.Value)
+                        return false;
+                }
+                return true;
+            }
+
+            /// <summary>
+            /// Gets the MVIDs of every assembly whose types the generator would look at for <paramref name="root"/>.
+            /// </summary>
+            private static Dictionary<string, Guid> CollectDependencies(Type root)
+            {
+                const BindingFlags memberFlags = BindingFlags.Instance | BindingFlags.Public | BindingFlags.NonPublic;
+
+                var result = new Dictionary<string, Guid>();
+                var visited = new HashSet<Type>();
+                var pending = new Stack<Type>();
+                pending.Push(root);
+
+                while (pending.Count > 0)
+                {
+                    var type = pending.Pop();
+                    if (type.IsGenericParameter || !visited.Add(type)) continue;
+
+                    if (type.HasElementType)
+                        pending.Push(type.GetElementType());
+                    if (type.IsGenericType)
+                    {
+                        foreach (var arg in type.GetGenericArguments())
+                            pending.Push(arg);
+                    }
+
+                    var asm = type.Assembly;
+                    if (asm == typeof(object).Assembly || asm == typeof(GeneratedStoreImpl).Assembly)
+                        continue; // these are covered by the generator's MVID
+
+                    result[asm.FullName] = asm.ManifestModule.ModuleVersionId;
+
+                    // only look inside the types that the generator itself would look inside
+                    if (type.IsPrimitive || type.IsEnum || type == typeof(string) || typeof(IEnumerable).IsAssignableFrom(type))
+                        continue;
+
+                    if (type.BaseType != null)
+                        pending.Push(type.BaseType);
+
+                    foreach (var member in type.GetMembers(memberFlags))
+                    {
+                        if (member is PropertyInfo prop)
+                            pending.Push(prop.PropertyType);
+                        else if (member is FieldInfo field)
+                            pending.Push(field.FieldType);
+                        else
+                            continue;
+
+                        foreach (var attr in member.GetCustomAttributes(typeof(UseConverterAttribute), true).Cast<UseConverterAttribute>())
+                        {
+                            if (attr.ConverterType != null)
+                                pending.Push(attr.ConverterType);
+                        }
+                    }
+                }
+
+                return result;
+            }
+        }
+    }
+}
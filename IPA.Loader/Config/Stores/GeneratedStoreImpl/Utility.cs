@@ -244,6 +244,8 @@ namespace IPA.Config.Stores
             if (valT == typeof(string)
              || valT == typeof(char)) return typeof(Text);
             if (valT == typeof(bool)) return typeof(Boolean);
+            // enums can be read from names, numbers, or the map older versions wrote, so they accept any Value
+            if (valT.IsEnum) return typeof(Value);
             if (valT == typeof(byte)
              || valT == typeof(sbyte)
              || valT == typeof(short)
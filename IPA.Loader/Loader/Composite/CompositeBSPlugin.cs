@@ -10,26 +10,35 @@ namespace IPA.Loader.Composite
 {
     internal class CompositeBSPlugin
     {
-        private readonly IEnumerable<PluginExecutor> plugins;
+        private readonly Func<IEnumerable<PluginExecutor>> plugins;
 
         private delegate Task CompositeCall(PluginExecutor plugin);
 
-        public CompositeBSPlugin(IEnumerable<PluginExecutor> plugins)
+        public CompositeBSPlugin(Func<IEnumerable<PluginExecutor>> plugins)
         {
             this.plugins = plugins;
         }
         private void Invoke(CompositeCall callback, [CallerMemberName] string method = "")
         {
-            foreach (var plugin in plugins)
+            foreach (var plugin in plugins())
             {
                 try
                 {
                     if (plugin != null)
                     {
-                        callback(plugin).ContinueWith(t =>
+                        var task = callback(plugin);
+                        if (task.IsCompleted)
+                        { // most lifecycle methods are synchronous, so don't make a continuation for them
+                            if (task.IsFaulted)
+                                Logger.Default.Error($"{plugin.Metadata.Name} {method}: {task.Exception!.InnerException}");
+                        }
+                        else
                         {
-                            Logger.Default.Error($"{plugin.Metadata.Name} {method}: {t.Exception!.InnerException}");
-                        }, CancellationToken.None, TaskContinuationOptions.OnlyOnFaulted, TaskScheduler.Default);
+                            _ = task.ContinueWith(t =>
+                            {
+                                Logger.Default.Error($"{plugin.Metadata.Name} {method}: {t.Exception!.InnerException}");
+                            }, CancellationToken.None, TaskContinuationOptions.OnlyOnFaulted, TaskScheduler.Default);
+                        }
                     }
                 }
                 catch (Exception ex)
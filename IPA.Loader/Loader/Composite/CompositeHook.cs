@@ -0,0 +1,129 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using Logger = IPA.Logging.Logger;
+
+namespace IPA.Loader.Composite
+{
+    /// <summary>
+    /// One hook of an interface, for every plugin that actually implements it.
+    /// </summary>
+    /// <remarks>
+    /// The delegates are bound directly to each plugin's implementation of the hook when this is built, so calling
+    /// the hook needs no type tests or interface dispatch, and doesn't allocate. Plugins whose implementation is
+    /// empty are left out entirely, which for per-frame hooks is most of them.
+    /// </remarks>
+    /// <typeparam name="TDelegate">the delegate type matching the signature of the hook</typeparam>
+    internal sealed class CompositeHook<TDelegate> where TDelegate : Delegate
+    {
+        public TDelegate[] Delegates { get; }
+        public string[] Names { get; } // parallel to Delegates, for error messages
+
+        private CompositeHook(TDelegate[] delegates, string[] names)
+        {
+            Delegates = delegates;
+            Names = names;
+        }
+
+        public static CompositeHook<TDelegate> Create<TPlugin>(IEnumerable<TPlugin> plugins, Func<TPlugin, string> getName,
+            Type interfaceType, string hookName)
+        {
+            var hook = interfaceType.GetMethod(hookName)
+                ?? throw new ArgumentException($"{interfaceType} has no method {hookName}", nameof(hookName));
+
+            var delegates = new List<TDelegate>();
+            var names = new List<string>();
+            foreach (var plugin in plugins)
+            {
+                if (plugin == null || !interfaceType.IsInstanceOfType(plugin)) continue;
+
+                var target = hook;
+                try
+                {
+                    var map = plugin.GetType().GetInterfaceMap(interfaceType);
+                    target = map.TargetMethods[Array.IndexOf(map.InterfaceMethods, hook)];
+                }
+                catch (ArgumentException)
+                { // fall back to binding to the interface method
+                }
+
+                if (IsEmpty(target)) continue;
+
+                TDelegate del;
+                try
+                {
+                    del = (TDelegate)Delegate.CreateDelegate(typeof(TDelegate), plugin, target);
+                }
+                catch (ArgumentException)
+                {
+                    del = (TDelegate)Delegate.CreateDelegate(typeof(TDelegate), plugin, hook);
+                }
+
+                delegates.Add(del);
+                names.Add(getName(plugin));
+            }
+
+            return new CompositeHook<TDelegate>(delegates.ToArray(), names.ToArray());
+        }
+
+        // a method is empty if its body is nothing but a ret, and maybe some nops from a debug build
+        private static bool IsEmpty(MethodInfo method)
+        {
+            if (method.IsAbstract) return false;
+
+            byte[] il;
+            try
+            {
+                il = method.GetMethodBody()?.GetILAsByteArray();
+            }
+            catch (Exception e) when (e is InvalidOperationException or NotSupportedException or MemberAccessException)
+            {
+                return false;
+            }
+            if (il == null || il.Length == 0) return false;
+
+            const byte Nop = 0x00, Ret = 0x2A;
+            for (var i = 0; i < il.Length - 1; i++)
+            {
+                if (il[i] != Nop) return false;
+            }
+            return il[il.Length - 1] == Ret;
+        }
+    }
+
+    internal static class CompositeHook
+    {
+        public static void Invoke(this CompositeHook<Action> hook, [CallerMemberName] string member = "")
+        {
+            var delegates = hook.Delegates;
+            for (var i = 0; i < delegates.Length; i++)
+            {
+                try
+                {
+                    delegates[i]();
+                }
+                catch (Exception ex)
+                {
+                    Logger.Default.Error($"{hook.Names[i]} {member}: {ex}");
+                }
+            }
+        }
+
+        public static void Invoke<T>(this CompositeHook<Action<T>> hook, T arg, [CallerMemberName] string member = "")
+        {
+            var delegates = hook.Delegates;
+            for (var i = 0; i < delegates.Length; i++)
+            {
+                try
+                {
+                    delegates[i](arg);
+                }
+                catch (Exception ex)
+                {
+                    Logger.Default.Error($"{hook.Names[i]} {member}: {ex}");
+                }
+            }
+        }
+    }
+}
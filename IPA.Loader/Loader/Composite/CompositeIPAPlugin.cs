@@ -12,10 +12,24 @@ namespace IPA.Loader.Composite
         private readonly IEnumerable<Old.IPlugin> plugins;
 
         private delegate void CompositeCall(Old.IPlugin plugin);
+
+        // the hooks that get called often are built once, for just the plugins that implement them
+        private readonly CompositeHook<Action> update;
+        private readonly CompositeHook<Action> fixedUpdate;
+        private readonly CompositeHook<Action> lateUpdate;
+        private readonly CompositeHook<Action<int>> levelWasLoaded;
+        private readonly CompositeHook<Action<int>> levelWasInitialized;
         
         public CompositeIPAPlugin(IEnumerable<Old.IPlugin> plugins) 
         {
             this.plugins = plugins;
+
+            static string GetName(Old.IPlugin plugin) => plugin.Name;
+            update = CompositeHook<Action>.Create(plugins, GetName, typeof(Old.IPlugin), nameof(Old.IPlugin.OnUpdate));
+            fixedUpdate = CompositeHook<Action>.Create(plugins, GetName, typeof(Old.IPlugin), nameof(Old.IPlugin.OnFixedUpdate));
+            lateUpdate = CompositeHook<Action>.Create(plugins, GetName, typeof(Old.IEnhancedPlugin), nameof(Old.IEnhancedPlugin.OnLateUpdate));
+            levelWasLoaded = CompositeHook<Action<int>>.Create(plugins, GetName, typeof(Old.IPlugin), nameof(Old.IPlugin.OnLevelWasLoaded));
+            levelWasInitialized = CompositeHook<Action<int>>.Create(plugins, GetName, typeof(Old.IPlugin), nameof(Old.IPlugin.OnLevelWasInitialized));
         }
 
         public void OnApplicationStart() 
@@ -45,12 +59,12 @@ namespace IPA.Loader.Composite
 
         public void OnUpdate() 
         {
-            Invoke(plugin => plugin.OnUpdate());
+            update.Invoke();
         }
 
         public void OnFixedUpdate() 
         {
-            Invoke(plugin => plugin.OnFixedUpdate());
+            fixedUpdate.Invoke();
         }
         
         public string Name => throw new InvalidOperationException();
@@ -59,20 +73,17 @@ namespace IPA.Loader.Composite
 
         public void OnLateUpdate() 
         {
-            Invoke(plugin => {
-                if (plugin is Old.IEnhancedPlugin saberPlugin)
-                    saberPlugin.OnLateUpdate();
-            });
+            lateUpdate.Invoke();
         }
 
         public void OnLevelWasLoaded(int level)
         {
-            Invoke(plugin => plugin.OnLevelWasLoaded(level));
+            levelWasLoaded.Invoke(level);
         }
 
         public void OnLevelWasInitialized(int level)
         {
-            Invoke(plugin => plugin.OnLevelWasInitialized(level));
+            levelWasInitialized.Invoke(level);
         }
     }
 #pragma warning restore CS0618 // Type or member is obsolete
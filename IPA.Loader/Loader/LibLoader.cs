@@ -24,6 +24,9 @@ namespace IPA.Loader
             if (name.Name == CurrentAssemblyName)
                 return AssemblyDefinition.ReadAssembly(CurrentAssemblyPath, parameters);
 
+            if (LibLoader.IdentityLocations.TryGetValue(name.FullName, out var path) && File.Exists(path))
+                return AssemblyDefinition.ReadAssembly(path, parameters);
+
             if (LibLoader.FilenameLocations.TryGetValue($"{name.Name}.dll", out var assemblyInfo))
             {
                 if (File.Exists(assemblyInfo.Path))
@@ -44,7 +47,10 @@ namespace IPA.Loader
     {
         internal static string LibraryPath => Path.Combine(Environment.CurrentDirectory, "Libs");
         internal static string NativeLibraryPath => Path.Combine(LibraryPath, "Native");
+        internal static string IndexPath => Path.Combine(Environment.CurrentDirectory, "UserData", ".LibraryIndex");
         internal static Dictionary<string, (string Path, Version Version)> FilenameLocations = null!;
+        // full assembly name to path, for requests that know exactly what they want
+        internal static Dictionary<string, string> IdentityLocations = null!;
 
         internal static void Configure()
         {
@@ -58,44 +64,35 @@ namespace IPA.Loader
             if (FilenameLocations == null || force)
             {
                 FilenameLocations = new Dictionary<string, (string, Version)>();
+                IdentityLocations = new Dictionary<string, string>(StringComparer.OrdinalIgnoreCase);
 
-                var files = TraverseTree(Path.GetDirectoryName(Assembly.GetExecutingAssembly().Location)!)
-                    .Concat(TraverseTree(LibraryPath, s => s != NativeLibraryPath));
+                var index = LibraryIndex.Get(IndexPath,
+                    new[] { Path.GetDirectoryName(Assembly.GetExecutingAssembly().Location)!, LibraryPath },
+                    NativeLibraryPath);
 
-                foreach (var fileInfo in files)
+                foreach (var file in index.Files)
                 {
-                    if (!fileInfo.Extension.Equals(".dll", StringComparison.OrdinalIgnoreCase))
+                    if (file.AssemblyName == null) continue;
+
+                    var fileName = Path.GetFileName(file.Path);
+                    var assemblyName = new AssemblyName(file.AssemblyName);
+                    if (!FilenameLocations.TryGetValue(fileName, out var assemblyInfo) || assemblyName.Version > assemblyInfo.Version)
                     {
-                        continue;
+                        FilenameLocations[fileName] = (file.Path, assemblyName.Version);
                     }
-
-                    try
+                    else
                     {
-                        var assemblyName = AssemblyName.GetAssemblyName(fileInfo.FullName);
-                        if (!FilenameLocations.TryGetValue(fileInfo.Name, out var assemblyInfo) || assemblyName.Version > assemblyInfo.Version)
-                        {
-                            FilenameLocations[fileInfo.Name] = (fileInfo.FullName, assemblyName.Version);
-                        }
-                        else
-                        {
-                            Log(Logger.Level.Notice, $"Multiple instances of {fileInfo.Name} exist! Ignoring {fileInfo.FullName}");
-                        }
+                        Log(Logger.Level.Notice, $"Multiple instances of {fileName} exist! Ignoring {file.Path}");
                     }
-                    catch (BadImageFormatException) { }
-                }
 
-                static void AddDirectoryToPath(string path)
-                {
-                    Environment.SetEnvironmentVariable("Path", path + Path.PathSeparator + Environment.GetEnvironmentVariable("Path"));
+                    if (!IdentityLocations.ContainsKey(assemblyName.FullName))
+                        IdentityLocations.Add(assemblyName.FullName, file.Path);
                 }
 
-                if (Directory.Exists(NativeLibraryPath))
-                {
-                    AddDirectoryToPath(NativeLibraryPath);
-                    _ = TraverseTree(NativeLibraryPath, dir =>
-                    { // this is a terrible hack for iterating directories
-                        AddDirectoryToPath(dir); return true;
-                    }).All(f => true); // force it to iterate all
+                if (index.NativeDirectories.Count > 0)
+                { // each directory used to be prepended in turn, so the last one found comes first
+                    var paths = Enumerable.Reverse(index.NativeDirectories).Append(Environment.GetEnvironmentVariable("Path"));
+                    Environment.SetEnvironmentVariable("Path", string.Join(Path.PathSeparator.ToString(), paths));
                 }
 
                 _ = LoadLibrary(new AssemblyName("Newtonsoft.Json, Version=12.0.0.0, Culture=neutral"));
@@ -115,6 +112,12 @@ namespace IPA.Loader
 
             SetupAssemblyFilenames();
 
+            if (IdentityLocations.TryGetValue(asmName.FullName, out var identityPath))
+            {
+                Log(Logger.Level.Debug, $"Found {asmName} as {identityPath}");
+                return LoadSafe(identityPath);
+            }
+
             var testFile = $"{asmName.Name}.dll";
             Log(Logger.Level.Debug, $"Looking for file {asmName.Name}.dll");
 
@@ -188,57 +191,5 @@ namespace IPA.Loader
 
         private static void AssemblyLibLoaderCallLogger(Logger.Level lvl, string message) => Logger.LibLoader.Log(lvl, message);
         private static void AssemblyLibLoaderCallLogger(Logger.Level lvl, Exception message) => Logger.LibLoader.Log(lvl, message);
-
-        // https://docs.microsoft.com/en-us/dotnet/csharp/programming-guide/file-system/how-to-iterate-through-a-directory-tree
-        private static IEnumerable<FileInfo> TraverseTree(string root, Func<string, bool>? dirValidator = null)
-        {
-            if (dirValidator == null) dirValidator = s => true;
-
-            var dirs = new Stack<string>(32);
-
-            if (!Directory.Exists(root))
-                throw new ArgumentException("Directory does not exist", nameof(root));
-            dirs.Push(root);
-
-            while (dirs.Count > 0)
-            {
-                string currentDir = dirs.Pop();
-                string[] subDirs;
-                try
-                {
-                    subDirs = Directory.GetDirectories(currentDir);
-                }
-                catch (UnauthorizedAccessException)
-                { continue; }
-                catch (DirectoryNotFoundException)
-                { continue; }
-
-                string[] files;
-                try
-                {
-                    files = Directory.GetFiles(currentDir);
-                }
-                catch (UnauthorizedAccessException)
-                { continue; }
-                catch (DirectoryNotFoundException)
-                { continue; }
-
-                foreach (string str in subDirs)
-                    if (dirValidator(str)) dirs.Push(str);
-
-                foreach (string file in files)
-                {
-                    FileInfo nextValue;
-                    try
-                    {
-                        nextValue = new FileInfo(file);
-                    }
-                    catch (FileNotFoundException)
-                    { continue; }
-
-                    yield return nextValue;
-                }
-            }
-        }
     }
 }
@@ -0,0 +1,274 @@
+﻿#nullable enable
+using IPA.Logging;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Reflection;
+
+namespace IPA.Loader
+{
+    /// <summary>
+    /// The set of libraries <see cref="LibLoader"/> can resolve, and the native library directories, which is kept on
+    /// disk so that an unchanged install doesn't have to be walked and have every assembly opened on each launch.
+    /// </summary>
+    /// <remarks>
+    /// <para>
+    /// The index is valid as long as every directory that was walked has the same modification time (which changes
+    /// when anything is added, removed, or renamed in it), and every file has the same size and modification time.
+    /// </para>
+    /// <para>
+    /// When it isn't, the tree is walked again, but files that haven't changed keep their assembly names from the old
+    /// index, so only new or changed files are opened.
+    /// </para>
+    /// <para>
+    /// This runs before any other assemblies can be resolved, so it only uses the BCL.
+    /// </para>
+    /// </remarks>
+    internal sealed class LibraryIndex
+    {
+        private const int FormatVersion = 1;
+
+        internal sealed class IndexedFile
+        {
+            public string Path = "";
+            public long Length;
+            public long WriteTime;
+            public string? AssemblyName; // null if the file isn't an assembly
+        }
+
+        private readonly List<string> roots = new();
+        private readonly List<(string Path, long WriteTime)> directories = new();
+
+        /// <summary>
+        /// The directories under <c>Libs\Native</c>, in the order they were found.
+        /// </summary>
+        public List<string> NativeDirectories { get; } = new();
+
+        /// <summary>
+        /// Every <c>.dll</c> in the library roots, in the order they were found.
+        /// </summary>
+        public List<IndexedFile> Files { get; } = new();
+
+        private static LibraryIndex? current;
+
+        public static LibraryIndex Get(string indexPath, IEnumerable<string> libraryRoots, string nativeRoot)
+        {
+            var rootList = libraryRoots.Append(nativeRoot).ToList();
+
+            var index = current ?? Load(indexPath);
+            if (index != null && index.roots.SequenceEqual(rootList, StringComparer.OrdinalIgnoreCase) && index.IsCurrent())
+                return current = index;
+
+            LibLoader.Log(Logger.Level.Debug, "Library index is out of date, rebuilding");
+            current = Build(rootList, nativeRoot, index);
+            current.Save(indexPath);
+            return current;
+        }
+
+        private static long GetWriteTime(string path) => Directory.GetLastWriteTimeUtc(path).Ticks;
+
+        private bool IsCurrent()
+        {
+            foreach (var (path, writeTime) in directories)
+            {
+                if (GetWriteTime(path) != writeTime)
+                    return false;
+            }
+
+            foreach (var file in Files)
+            {
+                var info = new FileInfo(file.Path);
+                if (!info.Exists || info.Length != file.Length || info.LastWriteTimeUtc.Ticks != file.WriteTime)
+                    return false;
+            }
+
+            return true;
+        }
+
+        private static LibraryIndex Build(List<string> rootList, string nativeRoot, LibraryIndex? previous)
+        {
+            var index = new LibraryIndex();
+            index.roots.AddRange(rootList);
+
+            var previousFiles = new Dictionary<string, IndexedFile>(StringComparer.OrdinalIgnoreCase);
+            if (previous != null)
+            {
+                foreach (var file in previous.Files)
+                    previousFiles[file.Path] = file;
+            }
+
+            foreach (var root in rootList)
+            {
+                if (root == nativeRoot)
+                {
+                    if (!Directory.Exists(root)) continue;
+                    index.NativeDirectories.Add(root);
+                    index.Walk(root, dir => { index.NativeDirectories.Add(dir); return true; }, null);
+                }
+                else
+                {
+                    index.Walk(root, dir => dir != nativeRoot, file =>
+                    {
+                        if (!file.Extension.Equals(".dll", StringComparison.OrdinalIgnoreCase))
+                            return;
+
+                        var length = file.Length;
+                        var writeTime = file.LastWriteTimeUtc.Ticks;
+                        if (previousFiles.TryGetValue(file.FullName, out var known)
+                            && known.Length == length && known.WriteTime == writeTime)
+                        {
+                            index.Files.Add(known);
+                            return;
+                        }
+
+                        string? name = null;
+                        try
+                        {
+                            name = AssemblyName.GetAssemblyName(file.FullName).FullName;
+                        }
+                        catch (BadImageFormatException) { }
+
+                        index.Files.Add(new IndexedFile
+                        {
+                            Path = file.FullName,
+                            Length = length,
+                            WriteTime = writeTime,
+                            AssemblyName = name,
+                        });
+                    });
+                }
+            }
+
+            return index;
+        }
+
+        // walks the same way (and so in the same order) that LibLoader always has
+        private void Walk(string root, Func<string, bool> dirValidator, Action<FileInfo>? onFile)
+        {
+            if (!Directory.Exists(root))
+                throw new ArgumentException("Directory does not exist", nameof(root));
+
+            var dirs = new Stack<string>(32);
+            dirs.Push(root);
+
+            while (dirs.Count > 0)
+            {
+                var currentDir = dirs.Pop();
+                string[] subDirs;
+                string[] files;
+                try
+                {
+                    // read the time first, so that a change while we're listing makes the index stale rather than wrong
+                    directories.Add((currentDir, GetWriteTime(currentDir)));
+                    subDirs = Directory.GetDirectories(currentDir);
+                    files = onFile == null ? Array.Empty<string>() : Directory.GetFiles(currentDir);
+                }
+                catch (Exception e) when (e is UnauthorizedAccessException or DirectoryNotFoundException)
+                { continue; }
+
+                foreach (var str in subDirs)
+                    if (dirValidator(str)) dirs.Push(str);
+
+                foreach (var file in files)
+                {
+                    FileInfo info;
+                    try
+                    {
+                        info = new FileInfo(file);
+                        if (!info.Exists) continue;
+                    }
+                    catch (FileNotFoundException)
+                    { continue; }
+
+                    onFile!(info);
+                }
+            }
+        }
+
+        private static LibraryIndex? Load(string indexPath)
+        {
+            try
+            {
+                if (!File.Exists(indexPath)) return null;
+
+                using var reader = new BinaryReader(File.OpenRead(indexPath));
+                if (reader.ReadInt32() != FormatVersion) return null;
+
+                var index = new LibraryIndex();
+                for (int i = 0, count = reader.ReadInt32(); i < count; i++)
+                    index.roots.Add(reader.ReadString());
+                for (int i = 0, count = reader.ReadInt32(); i < count; i++)
+                    index.directories.Add((reader.ReadString(), reader.ReadInt64()));
+                for (int i = 0, count = reader.ReadInt32(); i < count; i++)
+                    index.NativeDirectories.Add(reader.ReadString());
+                for (int i = 0, count = reader.ReadInt32(); i < count; i++)
+                {
+                    var file = new IndexedFile
+                    {
+                        Path = reader.ReadString(),
+                        Length = reader.ReadInt64(),
+                        WriteTime = reader.ReadInt64(),
+                    };
+                    var name = reader.ReadString();
+                    file.AssemblyName = name.Length == 0 ? null : name;
+                    index.Files.Add(file);
+                }
+
+                return index;
+            }
+            catch (Exception e) when (e is IOException or UnauthorizedAccessException or FormatException)
+            {
+                LibLoader.Log(Logger.Level.Warning, "Could not read library index, rebuilding it");
+                LibLoader.Log(Logger.Level.Warning, e);
+                return null;
+            }
+        }
+
+        private void Save(string indexPath)
+        {
+            var dir = Path.GetDirectoryName(indexPath);
+            if (!Directory.Exists(dir)) return; // too early in a fresh install; it'll be written next launch
+
+            var temp = indexPath + ".tmp";
+            try
+            {
+                using (var writer = new BinaryWriter(File.Create(temp)))
+                {
+                    writer.Write(FormatVersion);
+                    writer.Write(roots.Count);
+                    foreach (var root in roots)
+                        writer.Write(root);
+                    writer.Write(directories.Count);
+                    foreach (var (path, writeTime) in directories)
+                    {
+                        writer.Write(path);
+                        writer.Write(writeTime);
+                    }
+                    writer.Write(NativeDirectories.Count);
+                    foreach (var native in NativeDirectories)
+                        writer.Write(native);
+                    writer.Write(Files.Count);
+                    foreach (var file in Files)
+                    {
+                        writer.Write(file.Path);
+                        writer.Write(file.Length);
+                        writer.Write(file.WriteTime);
+                        writer.Write(file.AssemblyName ?? "");
+                    }
+                }
+
+                if (File.Exists(indexPath))
+                    File.Replace(temp, indexPath, null, true);
+                else
+                    File.Move(temp, indexPath);
+            }
+            catch (Exception e) when (e is IOException or UnauthorizedAccessException)
+            {
+                LibLoader.Log(Logger.Level.Warning, "Could not save library index");
+                LibLoader.Log(Logger.Level.Warning, e);
+                try { File.Delete(temp); } catch { }
+            }
+        }
+    }
+}
@@ -0,0 +1,63 @@
+﻿#nullable enable
+using System.Collections.Generic;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace IPA.Loader
+{
+    /// <summary>
+    /// Tracks the plugins whose enable or disable is still running after the transaction that started it was committed.
+    /// </summary>
+    /// <remarks>
+    /// Until such a plugin's task completes, the registry can still show it in its old state, so a transaction made in
+    /// the meantime would match the current state and try to change the same plugin again.
+    /// </remarks>
+    internal sealed class PendingTransitions
+    {
+        private readonly HashSet<PluginMetadata> pending = new();
+
+        public int Count
+        {
+            get
+            {
+                lock (pending)
+                    return pending.Count;
+            }
+        }
+
+        /// <summary>
+        /// Gets the first of <paramref name="plugins"/> that is still being enabled or disabled.
+        /// </summary>
+        /// <returns>the plugin, or <see langword="null"/> if none of them are</returns>
+        public PluginMetadata? FirstPending(IEnumerable<PluginMetadata> plugins)
+        {
+            lock (pending)
+            {
+                if (pending.Count == 0) return null;
+                foreach (var meta in plugins)
+                {
+                    if (pending.Contains(meta))
+                        return meta;
+                }
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// Marks <paramref name="meta"/> as pending until <paramref name="task"/> completes.
+        /// </summary>
+        public void Track(PluginMetadata meta, Task task)
+        {
+            if (task.IsCompleted) return;
+
+            lock (pending)
+                _ = pending.Add(meta);
+
+            _ = task.ContinueWith(_ =>
+            {
+                lock (pending)
+                    _ = pending.Remove(meta);
+            }, CancellationToken.None, TaskContinuationOptions.ExecuteSynchronously, TaskScheduler.Default);
+        }
+    }
+}
@@ -34,7 +34,7 @@ namespace IPA.Loader
 
                 PluginManager.Load();
 
-                bsPlugins = new CompositeBSPlugin(PluginManager.BSMetas);
+                bsPlugins = new CompositeBSPlugin(() => PluginManager.BSMetas); // the enabled set changes at runtime
 #pragma warning disable 618
                 ipaPlugins = new CompositeIPAPlugin(PluginManager.Plugins);
 #pragma warning restore 618
@@ -48,6 +48,8 @@ namespace IPA.Loader
                 bsPlugins.OnEnable();
                 ipaPlugins.OnApplicationStart();
 
+                PluginProfiler.ReportInitialLoad();
+
                 SceneManager.activeSceneChanged += OnActiveSceneChanged;
                 SceneManager.sceneLoaded += OnSceneLoaded;
                 SceneManager.sceneUnloaded += OnSceneUnloaded;
@@ -57,10 +59,6 @@ namespace IPA.Loader
                     StartCoroutine(unitySched.Coroutine());
 
                 initialized = true;
-
-#if DEBUG
-                Config.Stores.GeneratedStoreImpl.DebugSaveAssembly($"{Config.Stores.GeneratedStoreImpl.GeneratedAssemblyName}.dll");
-#endif
             }
         }
 
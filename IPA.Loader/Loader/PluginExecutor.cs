@@ -32,6 +32,16 @@ namespace IPA.Loader
                 PrepareDelegates();
         }
 
+        /// <summary>
+        /// Creates an executor with no plugin type behind it, which runs the given lifecycle methods.
+        /// </summary>
+        internal PluginExecutor(PluginMetadata meta, Func<Task> enable, Func<Task> disable)
+            : this(meta, Special.Bare)
+        {
+            LifecycleEnable = o => enable();
+            LifecycleDisable = o => disable();
+        }
+
 
         public object Instance { get; private set; } = null;
         private Func<PluginMetadata, object> CreatePlugin { get; set; }
@@ -44,14 +54,25 @@ namespace IPA.Loader
             Instance = CreatePlugin(Metadata);
         }
 
-        public Task Enable() => LifecycleEnable(Instance);
-        public Task Disable() => LifecycleDisable(Instance);
+        public Task Enable()
+        {
+            if (SpecialType != Special.None) return LifecycleEnable(Instance);
+            using var profile = PluginProfiler.Measure(Metadata, PluginProfiler.Phase.Enable);
+            return LifecycleEnable(Instance);
+        }
+
+        public Task Disable()
+        {
+            if (SpecialType != Special.None) return LifecycleDisable(Instance);
+            using var profile = PluginProfiler.Measure(Metadata, PluginProfiler.Phase.Disable);
+            return LifecycleDisable(Instance);
+        }
 
 
         private void PrepareDelegates()
         { // TODO: use custom exception types or something
             PluginLoader.Load(Metadata);
-            var type = Metadata.Assembly.GetType(Metadata.PluginType.FullName);
+            var type = Metadata.TypeHandle.Resolve(Metadata.Assembly);
 
             CreatePlugin = MakeCreateFunc(type, Metadata.Name);
             LifecycleEnable = MakeLifecycleEnableFunc(type, Metadata.Name);
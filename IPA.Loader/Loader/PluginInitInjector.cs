@@ -3,6 +3,7 @@ using IPA.AntiMalware;
 using IPA.Logging;
 using IPA.Utilities;
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Linq;
 using System.Linq.Expressions;
@@ -103,42 +104,73 @@ namespace IPA.Loader
         /// <param name="type">the type of the parameter.</param>
         /// <param name="injector">the function to call for injection.</param>
         public static void AddInjector(Type type, InjectParameterNested injector)
-        {
-            injectors.Add(new TypedInjector(type, injector));
-        }
+            => AddInjector(new TypedInjector(type, injector));
 
-        private struct TypedInjector : IEquatable<TypedInjector>
+        private readonly struct TypedInjector
         {
-            public Type Type;
-            public InjectParameterNested Injector;
+            public readonly Type Type;
+            public readonly InjectParameterNested Injector;
 
             public TypedInjector(Type t, InjectParameterNested i)
             { Type = t; Injector = i; }
 
             public object? Inject(object? prev, ParameterInfo info, PluginMetadata meta, InjectedValueProvider provider)
                 => Injector(prev, info, meta, provider);
+        }
 
-            public bool Equals(TypedInjector other)
-                => Type == other.Type && Injector == other.Injector;
-
-            public override bool Equals(object obj)
-                => obj is TypedInjector i && Equals(i);
+        /// <summary>
+        /// An immutable snapshot of the registered injectors. Injectors are only ever appended, so an injector's index
+        /// in <see cref="Injectors"/> is stable across snapshots, and can be used to index previous values.
+        /// </summary>
+        private sealed class InjectorSet
+        {
+            public readonly TypedInjector[] Injectors;
+            private readonly ConcurrentDictionary<Type, int[]> candidatesByType = new();
+            private readonly Func<Type, int[]> resolveCandidates;
 
+            public InjectorSet(TypedInjector[] injectors)
+            {
+                Injectors = injectors;
+                resolveCandidates = ResolveCandidates;
+            }
 
-            public override int GetHashCode()
-                => Type.GetHashCode() ^ Injector.GetHashCode();
+            public InjectorSet With(TypedInjector injector)
+            {
+                var arr = new TypedInjector[Injectors.Length + 1];
+                Array.Copy(Injectors, arr, Injectors.Length);
+                arr[Injectors.Length] = injector;
+                return new InjectorSet(arr);
+            }
 
-            public static bool operator ==(TypedInjector a, TypedInjector b) => a.Equals(b);
-            public static bool operator !=(TypedInjector a, TypedInjector b) => !a.Equals(b);
+            /// <summary>
+            /// Gets the indicies of the injectors which can provide <paramref name="paramType"/>, in order of closest match.
+            /// </summary>
+            public int[] CandidatesFor(Type paramType)
+                => candidatesByType.GetOrAdd(paramType, resolveCandidates);
+
+            private int[] ResolveCandidates(Type paramType)
+                => Injectors
+                    .Select((inject, index) => (index, priority: MatchPriority(paramType, inject.Type))) // check match priority, combine it
+                    .NonNull(t => t.priority)                                                          // filter null priorities
+                    .OrderByDescending(t => t.priority!.Value)                                         // sort by value (stable)
+                    .Select(t => t.index)                                                              // remove priority value
+                    .ToArray();
         }
 
-        private static readonly List<TypedInjector> injectors = new()
+        private static readonly object addInjectorLock = new();
+        private static volatile InjectorSet injectors = new(new[]
         {
             new TypedInjector(typeof(Logger), (prev, param, meta, _) => prev ?? new StandardLogger(meta.Name)),
             new TypedInjector(typeof(PluginMetadata), (prev, param, meta, _) => prev ?? meta),
             new TypedInjector(typeof(Config.Config), (prev, param, meta, _) => prev ?? Config.Config.GetConfigFor(meta.Name, param)),
             new TypedInjector(typeof(IAntiMalware), (prev, param, meta, _) => prev ?? AntiMalwareEngine.Engine)
-        };
+        });
+
+        private static void AddInjector(TypedInjector injector)
+        {
+            lock (addInjectorLock)
+                injectors = injectors.With(injector);
+        }
 
         private static int? MatchPriority(Type target, Type source)
         {
@@ -162,93 +194,119 @@ namespace IPA.Loader
             }
         }
 
-        private static readonly MethodInfo InjectMethod = typeof(PluginInitInjector).GetMethod(nameof(Inject), BindingFlags.NonPublic | BindingFlags.Static);
         internal static Expression InjectedCallExpr(ParameterInfo[] initParams, Expression meta, Expression persistVar, Func<IEnumerable<Expression>, Expression> exprGen)
         {
-            var arr = Expression.Variable(typeof(object[]), "initArr");
-            return Expression.Block(new[] { arr },
-                Expression.Assign(arr, Expression.Call(InjectMethod, Expression.Constant(initParams), meta, persistVar)),
-                exprGen(initParams
-                            .Select(p => p.ParameterType)
-                            .Select((t, i) => (Expression)Expression.Convert(
-                                Expression.ArrayIndex(arr, Expression.Constant(i)), t))));
+            // the plan is embedded into the compiled delegate, so it is resolved once per signature and reused for every call
+            var plan = Expression.Constant(new InjectionPlan(initParams));
+            return exprGen(initParams
+                .Select((p, i) => (Expression)Expression.Call(plan,
+                    InjectionPlan.InjectMethod.MakeGenericMethod(p.ParameterType),
+                    Expression.Constant(i), meta, persistVar)));
         }
 
-        private static object? InjectForParameter(
-            Dictionary<TypedInjector, object?> previousValues,
-            PluginMetadata meta,
-            ParameterInfo param,
-            Type paramType,
-            InjectedValueProvider provider)
+        /// <summary>
+        /// The resolved injectors for each parameter of an <see cref="InitAttribute"/> method or constructor.
+        /// </summary>
+        /// <remarks>
+        /// This is resolved lazily against the current <see cref="InjectorSet"/>, and only re-resolved when
+        /// <see cref="AddInjector(Type, InjectParameterNested)"/> has replaced it since.
+        /// </remarks>
+        private sealed class InjectionPlan
         {
-            var value = paramType.GetDefault();
+            public static readonly MethodInfo InjectMethod = typeof(InjectionPlan).GetMethod(nameof(Inject));
 
-            var toUse = injectors
-                .Select(i => (inject: i, priority: MatchPriority(paramType, i.Type)))   // check match priority, combine it
-                .NonNull(t => t.priority)                             // filter null priorities
-                .Select(t => (t.inject, priority: t.priority!.Value)) // remove nullable
-                .OrderByDescending(t => t.priority)                    // sort by value
-                .Select(t => t.inject);                                // remove priority value
+            private readonly ParameterInfo[] parameters;
+            private Resolved? resolved;
 
-            // this tries injectors in order of closest match by type provided
-            foreach (var pair in toUse)
+            private sealed class Resolved
             {
-                object? prev = null;
-                if (previousValues.ContainsKey(pair))
-                    prev = previousValues[pair];
+                public readonly InjectorSet Set;
+                public readonly int[][] Candidates;
 
-                var val = pair.Inject(prev, param, meta, provider);
+                public Resolved(InjectorSet set, int[][] candidates)
+                {
+                    Set = set;
+                    Candidates = candidates;
+                }
+            }
 
-                previousValues[pair] = val;
+            public InjectionPlan(ParameterInfo[] parameters)
+                => this.parameters = parameters;
 
-                if (val == null) continue;
-                value = val;
-                break;
+            private Resolved Resolve()
+            {
+                var set = injectors;
+                var res = resolved;
+                if (res is not null && res.Set == set)
+                    return res;
+
+                var candidates = new int[parameters.Length][];
+                for (int i = 0; i < parameters.Length; i++)
+                    candidates[i] = set.CandidatesFor(parameters[i].ParameterType);
+                return resolved = new Resolved(set, candidates);
             }
 
-            return value;
+            public T Inject<T>(int index, PluginMetadata meta, ref object? persist)
+            {
+                var res = Resolve();
+                var state = InjectionState.For(meta, ref persist);
+                var value = state.InjectWith(res.Set, res.Candidates[index], parameters[index]);
+                return value is null ? default! : (T)value;
+            }
         }
 
-        private class InjectedValueProviderWrapperImplementation
+        /// <summary>
+        /// The per-plugin injection state, persisted between all <see cref="InitAttribute"/> calls for a plugin.
+        /// </summary>
+        private sealed class InjectionState
         {
-            public Dictionary<TypedInjector, object?> PreviousValues { get; }
-
             public PluginMetadata Meta { get; }
 
             public InjectedValueProvider Provider { get; }
 
-            public InjectedValueProviderWrapperImplementation(PluginMetadata meta)
+            // indexed by the injector's index in its InjectorSet
+            private object?[] previousValues;
+
+            private InjectionState(PluginMetadata meta)
             {
                 Meta = meta;
-                PreviousValues = new();
+                previousValues = new object?[injectors.Injectors.Length];
                 Provider = Inject;
             }
 
-            private object? Inject(ParameterInfo param, Type? typeOverride = null)
-                => InjectForParameter(PreviousValues, Meta, param, typeOverride ?? param.ParameterType, Provider);
-        }
-
-        internal static object?[] Inject(ParameterInfo[] initParams, PluginMetadata meta, ref object? persist)
-        {
-            var initArgs = new List<object?>();
-
-            var impl = persist as InjectedValueProviderWrapperImplementation;
-            if (impl == null || impl.Meta != meta)
+            public static InjectionState For(PluginMetadata meta, ref object? persist)
             {
-                impl = new(meta);
-                persist = impl;
+                if (persist is InjectionState state && state.Meta == meta)
+                    return state;
+                state = new(meta);
+                persist = state;
+                return state;
             }
 
-            foreach (var param in initParams)
+            public object? InjectWith(InjectorSet set, int[] candidates, ParameterInfo param)
             {
-                var paramType = param.ParameterType;
+                if (previousValues.Length < set.Injectors.Length)
+                    Array.Resize(ref previousValues, set.Injectors.Length);
 
-                var value = InjectForParameter(impl.PreviousValues, meta, param, paramType, impl.Provider);
+                // this tries injectors in order of closest match by type provided
+                foreach (var index in candidates)
+                {
+                    var val = set.Injectors[index].Inject(previousValues[index], param, Meta, Provider);
+                    previousValues[index] = val;
 
-                initArgs.Add(value);
+                    if (val != null)
+                        return val;
+                }
+
+                return null;
             }
 
-            return initArgs.ToArray();
+            private object? Inject(ParameterInfo param, Type? typeOverride = null)
+            {
+                var paramType = typeOverride ?? param.ParameterType;
+                var set = injectors;
+                return InjectWith(set, set.CandidatesFor(paramType), param) ?? paramType.GetDefault();
+            }
         }
     }
 }
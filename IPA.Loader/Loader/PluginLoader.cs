@@ -84,7 +84,7 @@ namespace IPA.Loader
                 {
                     Assembly = Assembly.GetExecutingAssembly(),
                     File = new FileInfo(Path.Combine(UnityGame.InstallPath, "IPA.exe")),
-                    PluginType = null,
+                    TypeHandle = null,
                     IsSelf = true
                 };
 
@@ -107,6 +107,24 @@ namespace IPA.Loader
                 Logger.Loader.Critical(e);
             }
 
+            // the modules are only needed until the description includes are processed, and are disposed after that
+            // so that their metadata doesn't stay in memory for the life of the game
+            var readAssemblies = new List<AssemblyDefinition>();
+            var pluginModules = new Dictionary<PluginMetadata, ModuleDefinition>();
+            try
+            {
+                LoadMetadata(plugins, readAssemblies, pluginModules);
+            }
+            finally
+            {
+                foreach (var assembly in readAssemblies)
+                    assembly.Dispose();
+            }
+        }
+
+        private static void LoadMetadata(string[] plugins, List<AssemblyDefinition> readAssemblies,
+            Dictionary<PluginMetadata, ModuleDefinition> pluginModules)
+        {
             using var resolver = new CecilLibLoader();
             resolver.AddSearchDirectory(UnityGame.LibraryPath);
             resolver.AddSearchDirectory(UnityGame.PluginsPath);
@@ -118,6 +136,7 @@ namespace IPA.Loader
                     IsSelf = false
                 };
 
+                using var profile = PluginProfiler.Measure(metadata, PluginProfiler.Phase.MetadataScan);
                 try
                 {
                     var scanResult = AntiMalwareEngine.Engine.ScanFile(metadata.File);
@@ -132,12 +151,14 @@ namespace IPA.Loader
                         continue;
                     }
 
-                    var pluginModule = AssemblyDefinition.ReadAssembly(metadata.File.FullName, new ReaderParameters
+                    var pluginAssembly = AssemblyDefinition.ReadAssembly(metadata.File.FullName, new ReaderParameters
                     {
                         ReadingMode = ReadingMode.Immediate,
                         ReadWrite = false,
                         AssemblyResolver = resolver
-                    }).MainModule;
+                    });
+                    readAssemblies.Add(pluginAssembly);
+                    var pluginModule = pluginAssembly.MainModule;
 
                     string pluginNs = "";
 
@@ -207,7 +228,7 @@ namespace IPA.Loader
                         var rtOptionsValInt = (int)rtOptionsArg.Value; // `int` is the underlying type of RuntimeOptions
 
                         meta.RuntimeOptions = (RuntimeOptions)rtOptionsValInt;
-                        meta.PluginType = type;
+                        meta.TypeHandle = new PluginTypeHandle(type);
                         return true;
                     }
 
@@ -231,10 +252,10 @@ namespace IPA.Loader
                             TryGetNamespacedPluginType(hint, metadata);
                     }
 
-                    if (metadata.PluginType == null)
+                    if (metadata.TypeHandle == null)
                         TryGetNamespacedPluginType(pluginNs, metadata);
 
-                    if (metadata.PluginType == null)
+                    if (metadata.TypeHandle == null)
                     {
                         Logger.Loader.Error($"No plugin found in the manifest {(hint != null ? $"hint path ({hint}) or " : "")}namespace ({pluginNs}) in {Path.GetFileName(plugin)}");
                         continue;
@@ -242,6 +263,7 @@ namespace IPA.Loader
 
                     Logger.Loader.Debug($"Adding info for {Path.GetFileName(plugin)}");
                     PluginsMetadata.Add(metadata);
+                    pluginModules.Add(metadata, pluginModule);
                 }
                 catch (Exception e)
                 {
@@ -308,10 +330,12 @@ namespace IPA.Loader
                     string description;
                     if (!meta.IsSelf)
                     {
-                        // plugin type must be non-null for non-self plugins
-                        var resc = meta.PluginType!.Module.Resources.Select(r => r as EmbeddedResource)
-                                                                   .NonNull()
-                                                                   .FirstOrDefault(r => r.Name == name);
+                        // every non-self plugin that got this far had its module read
+                        var resc = pluginModules.TryGetValue(meta, out var module)
+                            ? module.Resources.Select(r => r as EmbeddedResource)
+                                              .NonNull()
+                                              .FirstOrDefault(r => r.Name == name)
+                            : null;
                         if (resc == null)
                         {
                             Logger.Loader.Warn($"Could not find description file for plugin {meta.Name} ({name}); ignoring include");
@@ -580,21 +604,21 @@ namespace IPA.Loader
                     meta = null;
                     disabled = false;
                     ignored = true;
-                    Logger.Loader.Trace($"Trying to resolve plugin '{id}' partial:{partial}");
+                    Logger.Loader.Trace("Trying to resolve plugin '{0}' partial:{1}", id, partial);
                     if (loadedPlugins.TryGetValue(id, out var foundMeta))
                     {
                         meta = foundMeta.Meta;
                         disabled = foundMeta.Disabled;
                         ignored = foundMeta.Ignored;
-                        Logger.Loader.Trace($"- Found already processed");
+                        Logger.Loader.Trace("- Found already processed");
                         return true;
                     }
                     if (metadataCache.TryGetValue(id, out var plugin))
                     {
-                        Logger.Loader.Trace($"- In metadata cache");
+                        Logger.Loader.Trace("- In metadata cache");
                         if (partial)
                         {
-                            Logger.Loader.Trace($"  - but requested in a partial lookup");
+                            Logger.Loader.Trace("  - but requested in a partial lookup");
                             return false;
                         }
 
@@ -630,18 +654,18 @@ namespace IPA.Loader
                         if (!loadedPlugins.ContainsKey(id))
                         {
                             // this condition is specifically for when we fail resolution because of a graph loop
-                            Logger.Loader.Trace($"- '{id}' resolved as ignored:{ignored},disabled:{disabled}");
+                            Logger.Loader.Trace("- '{0}' resolved as ignored:{1},disabled:{2}", id, ignored, disabled);
                             loadedPlugins.Add(id, (plugin.Meta, disabled, ignored));
                         }
                         return true;
                     }
-                    Logger.Loader.Trace($"- Not found");
+                    Logger.Loader.Trace("- Not found");
                     return false;
                 }
 
                 void Resolve(PluginMetadata plugin, ref bool disabled, out bool ignored)
                 {
-                    Logger.Loader.Trace($">Resolving '{plugin.Name}'");
+                    Logger.Loader.Trace(">Resolving '{0}'", plugin.Name);
 
                     // first we need to check for loops in the resolution graph to prevent stack overflows
                     if (isProcessing.Contains(plugin))
@@ -754,7 +778,7 @@ namespace IPA.Loader
                     // after we handle dependencies and loadafters, then check conflicts
                     foreach (var (id, range) in plugin.Manifest.Conflicts)
                     {
-                        Logger.Loader.Trace($">- Checking conflict '{id}' {range}");
+                        Logger.Loader.Trace(">- Checking conflict '{0}' {1}", id, range);
                         // this lookup must be partial to prevent loadBefore/conflictsWith from creating a recursion loop
                         if (TryResolveId(id, out var meta, out var conflDisabled, out var conflIgnored, partial: true)
                             && range.Matches(meta.HVersion)
@@ -776,13 +800,13 @@ namespace IPA.Loader
                     if (!ignoredPlugins.ContainsKey(plugin))
                     {
                         // we can now load the current plugin
-                        Logger.Loader.Trace($"->'{plugin.Name}' loads here");
+                        Logger.Loader.Trace("->'{0}' loads here", plugin.Name);
                         outputOrder!.Add(plugin);
                     }
 
                     // loadbefores have already been preprocessed into loadafters
 
-                    Logger.Loader.Trace($">Processed '{plugin.Name}'");
+                    Logger.Loader.Trace(">Processed '{0}'", plugin.Name);
                 }
 
                 // run TryResolveId over every plugin, which recursively calculates load order
@@ -862,7 +886,7 @@ namespace IPA.Loader
                 foreach (var m in ignoredPlugins.Keys)
                 { // clean them up so we can still use the metadata for updates
                     m.InternalFeatures.Clear();
-                    m.PluginType = null;
+                    m.TypeHandle = null;
                     m.Assembly = null!;
                 }
             }
@@ -875,7 +899,7 @@ namespace IPA.Loader
 
         internal static void Load(PluginMetadata meta)
         {
-            if (meta is { Assembly: null, PluginType: not null })
+            if (meta is { Assembly: null, TypeHandle: not null })
                 meta.Assembly = Assembly.LoadFrom(meta.File.FullName);
         }
 
@@ -916,11 +940,13 @@ namespace IPA.Loader
             if (meta.IsBare)
                 return new PluginExecutor(meta, PluginExecutor.Special.Bare);
 
-            Load(meta);
+            using (PluginProfiler.Measure(meta, PluginProfiler.Phase.AssemblyLoad))
+                Load(meta);
 
             PluginExecutor exec;
             try
             {
+                using var profile = PluginProfiler.Measure(meta, PluginProfiler.Phase.ExecutorCompile);
                 exec = new PluginExecutor(meta);
             }
             catch (Exception e)
@@ -930,21 +956,25 @@ namespace IPA.Loader
                 return null;
             }
 
-            foreach (var feature in meta.Features)
+            using (PluginProfiler.Measure(meta, PluginProfiler.Phase.FeatureBeforeInit))
             {
-                try
+                foreach (var feature in meta.Features)
                 {
-                    feature.BeforeInit(meta);
-                }
-                catch (Exception e)
-                {
-                    Logger.Loader.Critical($"Feature errored in {nameof(Feature.BeforeInit)}:");
-                    Logger.Loader.Critical(e);
+                    try
+                    {
+                        feature.BeforeInit(meta);
+                    }
+                    catch (Exception e)
+                    {
+                        Logger.Loader.Critical($"Feature errored in {nameof(Feature.BeforeInit)}:");
+                        Logger.Loader.Critical(e);
+                    }
                 }
             }
 
             try
             {
+                using var profile = PluginProfiler.Measure(meta, PluginProfiler.Phase.Init);
                 exec.Create();
             }
             catch (Exception e)
@@ -959,6 +989,8 @@ namespace IPA.Loader
                 return null;
             }
 
+            using var afterInitProfile = PluginProfiler.Measure(meta, PluginProfiler.Phase.FeatureAfterInit);
+
             // TODO: make this new features system behave better wrt DynamicInit plugins
             foreach (var feature in meta.CreateFeaturesWhenLoaded)
             {
@@ -990,7 +1022,7 @@ namespace IPA.Loader
 
         internal static bool IsFirstLoadComplete { get; private set; }
 
-        internal static void LoadPlugins(List<PluginExecutor> list)
+        internal static void LoadPlugins(List<PluginExecutor> list, Action<PluginExecutor>? onPluginLoaded = null)
         {
             DisabledPlugins.ForEach(Load); // make sure they get loaded into memory so their metadata and stuff can be read more easily
 
@@ -1004,6 +1036,7 @@ namespace IPA.Loader
                     {
                         list.Add(exec);
                         _ = loaded.Add(meta);
+                        onPluginLoaded?.Invoke(exec);
                     }
                 }
                 catch (Exception e)
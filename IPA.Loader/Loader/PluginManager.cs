@@ -11,6 +11,7 @@ using System.Linq;
 using System.Reflection;
 using System.Runtime.InteropServices;
 using System.Text;
+using System.Threading;
 using System.Threading.Tasks;
 using UnityEngine;
 using Logger = IPA.Logging.Logger;
@@ -24,8 +25,11 @@ namespace IPA.Loader
     {
 #pragma warning disable CS0618 // Type or member is obsolete (IPlugin)
 
+        // this is only changed on the main thread, and every change is published to the PluginRegistry for readers
         private static List<PluginExecutor> _bsPlugins;
-        internal static IEnumerable<PluginExecutor> BSMetas => _bsPlugins;
+        internal static IEnumerable<PluginExecutor> BSMetas => PluginRegistry.Current.Executors;
+
+        private static void PublishState() => PluginRegistry.Publish(_bsPlugins, PluginLoader.DisabledPlugins);
 
         /// <summary>
         /// Gets info about the enabled plugin with the specified name.
@@ -33,7 +37,7 @@ namespace IPA.Loader
         /// <param name="name">the name of the plugin to get (must be an exact match)</param>
         /// <returns>the plugin metadata for the requested plugin or <see langword="null"/> if it doesn't exist or is disabled</returns>
         public static PluginMetadata GetPlugin(string name)
-            => BSMetas.Select(p => p.Metadata).FirstOrDefault(p => p.Name == name);
+            => PluginRegistry.Current.GetEnabledByName(name);
 
         /// <summary>
         /// Gets info about the enabled plugin with the specified ID.
@@ -41,7 +45,7 @@ namespace IPA.Loader
         /// <param name="id">the ID name of the plugin to get (must be an exact match)</param>
         /// <returns>the plugin metadata for the requested plugin or <see langword="null"/> if it doesn't exist or is disabled</returns>
         public static PluginMetadata GetPluginFromId(string id)
-            => BSMetas.Select(p => p.Metadata).FirstOrDefault(p => p.Id == id);
+            => PluginRegistry.Current.GetEnabledById(id);
 
         /// <summary>
         /// Gets a disabled plugin's metadata by its name.
@@ -49,7 +53,7 @@ namespace IPA.Loader
         /// <param name="name">the name of the disabled plugin to get</param>
         /// <returns>the metadata for the corresponding plugin</returns>
         public static PluginMetadata GetDisabledPlugin(string name) =>
-            DisabledPlugins.FirstOrDefault(p => p.Name == name);
+            PluginRegistry.Current.GetDisabledByName(name);
 
         /// <summary>
         /// Gets a disabled plugin's metadata by its ID.
@@ -57,16 +61,17 @@ namespace IPA.Loader
         /// <param name="id">the ID of the disabled plugin to get</param>
         /// <returns>the metadata for the corresponding plugin</returns>
         public static PluginMetadata GetDisabledPluginFromId(string id) =>
-            DisabledPlugins.FirstOrDefault(p => p.Id == id);
+            PluginRegistry.Current.GetDisabledById(id);
 
         /// <summary>
         /// Creates a new transaction for mod enabling and disabling mods simultaneously.
         /// </summary>
         /// <returns>a new <see cref="StateTransitionTransaction"/> that captures the current state of loaded mods</returns>
         public static StateTransitionTransaction PluginStateTransaction()
-            => new StateTransitionTransaction(EnabledPlugins, DisabledPlugins);
+            => new StateTransitionTransaction(PluginRegistry.Current);
 
         private static readonly object commitTransactionLockObject = new object();
+        private static readonly PendingTransitions pendingTransitions = new();
 
         internal static Task CommitTransaction(StateTransitionTransaction transaction)
         {
@@ -81,26 +86,35 @@ namespace IPA.Loader
 
             lock (commitTransactionLockObject)
             {
-                if (transaction.CurrentlyEnabled.Except(EnabledPlugins)
-                               .Concat(EnabledPlugins.Except(transaction.CurrentlyEnabled)).Any()
-                 || transaction.CurrentlyDisabled.Except(DisabledPlugins)
-                               .Concat(DisabledPlugins.Except(transaction.CurrentlyDisabled)).Any())
+                var state = PluginRegistry.Current;
+                // the versions only differ if something was committed since the transaction was made, and then the
+                // state has to be compared, in case it was changed back
+                if (transaction.BaseState.Version != state.Version && !transaction.BaseState.HasSameState(state))
                 { // ensure that the transaction's base state reflects the current state, otherwise throw
                     transaction.Dispose();
                     throw new InvalidOperationException("Transaction no longer resembles the current state of plugins");
                 }
+                // an earlier transaction may still be waiting to enable or disable some of these, and the state
+                // doesn't show that until it's done
+                if (pendingTransitions.FirstPending(transaction.ToEnable.Concat(transaction.ToDisable)) is { } busy)
+                {
+                    transaction.Dispose();
+                    throw new InvalidOperationException($"{busy.Name} is still being enabled or disabled by an earlier transaction");
+                }
 
                 var toEnable = transaction.ToEnable;
                 var toDisable = transaction.ToDisable;
                 transaction.Dispose();
 
+                var enabled = Task.CompletedTask;
                 using var disabledChangeTransaction = DisabledConfig.Instance.ChangeTransaction();
                 {
                     // first enable the mods that need to be
+                    var visited = new HashSet<PluginMetadata>();
                     void DeTree(List<PluginMetadata> into, IEnumerable<PluginMetadata> tree)
                     {
                         foreach (var st in tree)
-                            if (toEnable.Contains(st) && !into.Contains(st))
+                            if (toEnable.Contains(st) && visited.Add(st))
                             {
                                 DeTree(into, st.Dependencies);
                                 into.Add(st);
@@ -110,54 +124,48 @@ namespace IPA.Loader
                     var enableOrder = new List<PluginMetadata>();
                     DeTree(enableOrder, toEnable);
 
+                    // a plugin is enabled once the plugins it depends on have finished enabling, so only plugins that depend
+                    // on one with an asynchronous enable have to wait for it, and everything else is enabled right away
+                    var enableTasks = new Dictionary<PluginMetadata, Task>();
                     foreach (var meta in enableOrder)
                     {
-                        var executor = runtimeDisabledPlugins.FirstOrDefault(e => e.Metadata == meta);
-                        if (meta.RuntimeOptions == RuntimeOptions.DynamicInit)
-                        {
-                            if (executor != null)
-                                runtimeDisabledPlugins.Remove(executor);
-                            else
-                                executor = PluginLoader.InitPlugin(meta, EnabledPlugins);
-
-                            if (executor == null) continue; // couldn't initialize, skip to next
-                        }
-
-                        DisabledConfig.Instance.DisabledModIds.Remove(meta.Id ?? meta.Name);
-
-                        PluginEnabled?.Invoke(meta, meta.RuntimeOptions != RuntimeOptions.DynamicInit);
-
-                        if (meta.RuntimeOptions == RuntimeOptions.DynamicInit)
+                        var dependencies = meta.Dependencies
+                            .Select(d => enableTasks.TryGetValue(d, out var t) ? t : null)
+                            .NonNull().ToArray();
+                        var deferred = true;
+                        var task = RunAfter(dependencies, (_, inline) =>
                         {
-                            // it should only be marked as not disabled if it actually was
-                            PluginLoader.DisabledPlugins.Remove(meta);
-                            _bsPlugins.Add(executor);
-
-                            try
-                            {
-                                executor.Enable();
-                            }
-                            catch (Exception e)
-                            {
-                                Logger.Loader.Error($"Error while enabling {meta.Id}:");
-                                Logger.Loader.Error(e);
-                                // this should still be considered enabled, hence its position
-                            }
-                        }
+                            deferred = !inline;
+                            return EnablePlugin(meta, inline);
+                        });
+                        enableTasks.Add(meta, task);
+
+                        // a deferred plugin still shows as disabled until it runs, but one enabled here shows as enabled
+                        // already, even while its enable method is still running
+                        if (deferred)
+                            pendingTransitions.Track(meta, task);
                     }
+                    enabled = Task.WhenAll(enableTasks.Values);
                 }
 
                 var result = Task.CompletedTask;
                 {
                     // then disable the mods that need to be
-                    static DisableExecutor MakeDisableExec(PluginExecutor e)
+                    // this has to be the state before any of these are disabled, because the executors are taken from it
+                    var beforeDisable = PluginRegistry.Current;
+                    var disabling = new HashSet<PluginMetadata>(toDisable);
+                    DisableExecutor MakeDisableExec(PluginExecutor e)
                         => new DisableExecutor
                         {
                             Executor = e,
-                            Dependents = BSMetas.Where(f => f.Metadata.Dependencies.Contains(e.Metadata)).Select(MakeDisableExec)
+                            Dependents = beforeDisable.GetDependents(e.Metadata)
+                                .Where(disabling.Contains)
+                                .Select(m => beforeDisable.TryGetExecutor(m, out var dependent) ? dependent : null)
+                                .NonNull()
+                                .Select(MakeDisableExec)
                         };
 
-                    var disableExecs = toDisable.Select(m => BSMetas.FirstOrDefault(e => e.Metadata == m)).NonNull().ToArray(); // eagerly evaluate once
+                    var disableExecs = toDisable.Select(m => beforeDisable.TryGetExecutor(m, out var e) ? e : null).NonNull().ToArray(); // eagerly evaluate once
 
                     foreach (var exec in disableExecs)
                     {
@@ -166,12 +174,13 @@ namespace IPA.Loader
                         {
                             // it should only be marked as disabled if it was actually fully disabled
                             PluginLoader.DisabledPlugins.Add(exec.Metadata);
-                            runtimeDisabledPlugins.Add(exec);
+                            runtimeDisabledPlugins[exec.Metadata] = exec;
                             _bsPlugins.Remove(exec);
                         }
 
                         PluginDisabled?.Invoke(exec.Metadata, exec.Metadata.RuntimeOptions != RuntimeOptions.DynamicInit);
                     }
+                    PublishState();
 
                     var disableStructure = disableExecs.Select(MakeDisableExec);
 
@@ -184,39 +193,44 @@ namespace IPA.Loader
                             if (exec.Executor.Metadata.RuntimeOptions != RuntimeOptions.DynamicInit)
                                 return Task.FromException(new CannotRuntimeDisableException(exec.Executor.Metadata));
 
-                            var res = Task.WhenAll(exec.Dependents.Select(d => Disable(d, alreadyDisabled)))
-                                 .ContinueWith(t =>
-                                 {
-                                     if (t.IsFaulted)
-                                     {
-                                         return Task.WhenAll(t, Task.FromException(
-                                             new CannotRuntimeDisableException(exec.Executor.Metadata, "Dependents cannot be disabled for plugin")));
-                                     }
-                                     return exec.Executor.Disable()
-                                        .ContinueWith(t =>
+                            // independent plugins are disabled at the same time, so their asynchronous disables overlap,
+                            // and a plugin is disabled as soon as everything that depends on it has been
+                            var dependents = exec.Dependents.Select(d => Disable(d, alreadyDisabled)).ToArray();
+                            var res = RunAfter(dependents, (deps, _) =>
+                            {
+                                var failed = deps.Where(t => t.IsFaulted).ToArray();
+                                if (failed.Length > 0)
+                                {
+                                    return Task.WhenAll(failed.Append(Task.FromException(
+                                        new CannotRuntimeDisableException(exec.Executor.Metadata, "Dependents cannot be disabled for plugin"))));
+                                }
+                                return RunAfter(new[] { exec.Executor.Disable() }, (_, _) =>
+                                {
+                                    foreach (var feature in exec.Executor.Metadata.Features)
+                                    {
+                                        try
+                                        {
+                                            feature.AfterDisable(exec.Executor.Metadata);
+                                        }
+                                        catch (Exception e)
                                         {
-                                            foreach (var feature in exec.Executor.Metadata.Features)
-                                            {
-                                                try
-                                                {
-                                                    feature.AfterDisable(exec.Executor.Metadata);
-                                                }
-                                                catch (Exception e)
-                                                {
-                                                    Logger.Loader.Critical($"Feature errored in {nameof(Feature.AfterDisable)}: {e}");
-                                                }
-                                            }
-                                        }, UnityMainThreadTaskScheduler.Default);
-                                 }, UnityMainThreadTaskScheduler.Default).Unwrap();
+                                            Logger.Loader.Critical($"Feature errored in {nameof(Feature.AfterDisable)}: {e}");
+                                        }
+                                    }
+                                    return Task.CompletedTask;
+                                });
+                            });
                             // We do not want to call the disable method if a dependent couldn't be disabled
-                            // By scheduling on a UnityMainThreadScheduler, we ensure that Disable() is always called on the Unity main thread
+                            // RunAfter ensures that Disable() is always called on the Unity main thread
                             alreadyDisabled.Add(exec.Executor, res);
                             return res;
                         }
                     }
 
                     var disabled = new Dictionary<PluginExecutor, Task>();
-                    result = Task.WhenAll(disableStructure.Select(d => Disable(d, disabled)));
+                    result = Task.WhenAll(disableStructure.Select(d => Disable(d, disabled)).Append(enabled));
+                    foreach (var kvp in disabled)
+                        pendingTransitions.Track(kvp.Key.Metadata, kvp.Value);
                 }
 
                 OnAnyPluginsStateChanged?.Invoke(result, toEnable, toDisable);
@@ -230,6 +244,92 @@ namespace IPA.Loader
             }
         }
 
+        private static Task EnablePlugin(PluginMetadata meta, bool inCommit)
+        {
+            PluginExecutor executor = null;
+            if (meta.RuntimeOptions == RuntimeOptions.DynamicInit)
+            {
+                if (runtimeDisabledPlugins.TryGetValue(meta, out executor))
+                    runtimeDisabledPlugins.Remove(meta);
+                else
+                    executor = PluginLoader.InitPlugin(meta, PluginRegistry.Current.EnabledSet);
+
+                if (executor == null) return Task.CompletedTask; // couldn't initialize, skip to next
+            }
+
+            // if this was waiting on a dependency, the commit's config transaction is already over
+            using (inCommit ? null : DisabledConfig.Instance.ChangeTransaction())
+                DisabledConfig.Instance.DisabledModIds.Remove(meta.Id ?? meta.Name);
+
+            PluginEnabled?.Invoke(meta, meta.RuntimeOptions != RuntimeOptions.DynamicInit);
+
+            if (meta.RuntimeOptions != RuntimeOptions.DynamicInit)
+                return Task.CompletedTask;
+
+            // it should only be marked as not disabled if it actually was
+            PluginLoader.DisabledPlugins.Remove(meta);
+            _bsPlugins.Add(executor);
+            PublishState(); // the plugin should see itself as enabled when it is
+
+            // this should still be considered enabled if it fails, hence its position
+            void LogError(Exception e)
+            {
+                Logger.Loader.Error($"Error while enabling {meta.Id}:");
+                Logger.Loader.Error(e);
+            }
+
+            Task enableTask;
+            try
+            {
+                enableTask = executor.Enable();
+            }
+            catch (Exception e)
+            {
+                LogError(e);
+                return Task.CompletedTask;
+            }
+
+            if (enableTask.IsCompleted)
+            {
+                if (enableTask.IsFaulted)
+                    LogError(enableTask.Exception!.InnerException);
+                return Task.CompletedTask;
+            }
+            return enableTask.ContinueWith(t =>
+            {
+                if (t.IsFaulted)
+                    LogError(t.Exception!.InnerException);
+            }, CancellationToken.None, TaskContinuationOptions.ExecuteSynchronously, TaskScheduler.Default);
+        }
+
+        /// <summary>
+        /// Runs <paramref name="action"/> on the Unity main thread once all of <paramref name="prerequisites"/> have completed.
+        /// </summary>
+        /// <remarks>
+        /// If they have all already completed, which they usually have, since most lifecycle methods are synchronous, and
+        /// this is called from the main thread, the action runs immediately instead of waiting for the scheduler. The
+        /// action is given the prerequisites, and whether it ran immediately.
+        /// </remarks>
+        private static Task RunAfter(Task[] prerequisites, Func<Task[], bool, Task> action)
+        {
+            if (UnityGame.OnMainThread && prerequisites.All(t => t.IsCompleted))
+            {
+                try
+                {
+                    return action(prerequisites, true);
+                }
+                catch (Exception e)
+                {
+                    return Task.FromException(e);
+                }
+            }
+
+            if (prerequisites.Length == 0)
+                return UnityMainThreadTaskScheduler.Factory.StartNew(() => action(prerequisites, false)).Unwrap();
+            return Task.Factory.ContinueWhenAll(prerequisites, _ => action(prerequisites, false),
+                CancellationToken.None, TaskContinuationOptions.None, UnityMainThreadTaskScheduler.Default).Unwrap();
+        }
+
         private struct DisableExecutor
         {
             public PluginExecutor Executor;
@@ -241,14 +341,14 @@ namespace IPA.Loader
         /// </summary>
         /// <param name="meta">the plugin to check</param>
         /// <returns><see langword="true"/> if the plugin is disabled, <see langword="false"/> otherwise.</returns>
-        public static bool IsDisabled(PluginMetadata meta) => DisabledPlugins.Contains(meta);
+        public static bool IsDisabled(PluginMetadata meta) => PluginRegistry.Current.IsDisabled(meta);
 
         /// <summary>
         /// Checks if a given plugin is enabled.
         /// </summary>
         /// <param name="meta">the plugin to check</param>
         /// <returns><see langword="true"/> if the plugin is enabled, <see langword="false"/> otherwise.</returns>
-        public static bool IsEnabled(PluginMetadata meta) => BSMetas.Any(p => p.Metadata == meta);
+        public static bool IsEnabled(PluginMetadata meta) => PluginRegistry.Current.IsEnabled(meta);
 
 
         /// <summary>
@@ -306,13 +406,13 @@ namespace IPA.Loader
         /// Gets a collection of all enabled plugins, as represented by <see cref="PluginMetadata"/>.
         /// </summary>
         /// <value>a collection of all enabled plugins</value>
-        public static IEnumerable<PluginMetadata> EnabledPlugins => BSMetas.Select(p => p.Metadata);
+        public static IEnumerable<PluginMetadata> EnabledPlugins => PluginRegistry.Current.Enabled;
         /// <summary>
         /// Gets a list of disabled BSIPA plugins.
         /// </summary>
         /// <value>a collection of all disabled plugins as <see cref="PluginMetadata"/></value>
-        public static IEnumerable<PluginMetadata> DisabledPlugins => PluginLoader.DisabledPlugins;
-        private static readonly HashSet<PluginExecutor> runtimeDisabledPlugins = new HashSet<PluginExecutor>();
+        public static IEnumerable<PluginMetadata> DisabledPlugins => PluginRegistry.Current.Disabled;
+        private static readonly Dictionary<PluginMetadata, PluginExecutor> runtimeDisabledPlugins = new();
 
         /// <summary>
         /// Gets a read-only dictionary of an ignored plugin to the reason it was ignored, as an <see cref="IgnoreReason"/>.
@@ -330,6 +430,18 @@ namespace IPA.Loader
 
         internal static IConfigProvider SelfConfigProvider { get; set; }
 
+        /// <summary>
+        /// Replaces the loaded plugins with <paramref name="enabled"/>, with none disabled. Lets IPA.Tests commit
+        /// transactions over synthetic plugins.
+        /// </summary>
+        internal static void SetPlugins(IEnumerable<PluginExecutor> enabled)
+        {
+            _bsPlugins = enabled.ToList();
+            runtimeDisabledPlugins.Clear();
+            PluginLoader.DisabledPlugins = new List<PluginMetadata>();
+            PublishState();
+        }
+
         internal static void Load()
         {
             string pluginDirectory = UnityGame.PluginsPath;
@@ -344,8 +456,11 @@ namespace IPA.Loader
 
             var sw = Stopwatch.StartNew();
 
-            // initialize BSIPA plugins first
-            PluginLoader.LoadPlugins(_bsPlugins);
+            // initialize BSIPA plugins first, adding them to the registry as they load so that their init methods can find
+            // the disabled plugins, and the plugins loaded before them, then publish a snapshot that won't change again
+            PublishState();
+            PluginLoader.LoadPlugins(_bsPlugins, PluginRegistry.AddLoaded);
+            PublishState();
 
             var metadataPaths = new HashSet<string>(PluginLoader.PluginsMetadata.Select(m => m.File.FullName));
             var ignoredPaths = new HashSet<string>(PluginLoader.ignoredPlugins.Select(m => m.Key.File.FullName)
@@ -7,6 +7,7 @@ using System.Collections.Generic;
 using System.IO;
 using System.Linq;
 using System.Reflection;
+using System.Threading;
 using SVersion = SemVer.Version;
 using Version = Hive.Versioning.Version;
 
@@ -23,11 +24,64 @@ namespace IPA.Loader
         /// <value>the loaded Assembly that contains the plugin main type</value>
         public Assembly Assembly { get; internal set; } = null!;
 
+        /// <summary>
+        /// A handle to the main type of the plugin.
+        /// </summary>
+        /// <value>the handle to the plugin main type</value>
+        public PluginTypeHandle? TypeHandle { get; internal set; }
+
         /// <summary>
         /// The TypeDefinition for the main type of the plugin.
         /// </summary>
+        /// <remarks>
+        /// <para>
+        /// The loader no longer keeps Cecil definitions around after discovery, so this reads the plugin's
+        /// assembly again when it is first accessed, and whenever the definition it returned before has been collected.
+        /// The assembly is read lazily, and its file stays open for as long as the definition is alive.
+        /// </para>
+        /// <para>
+        /// The loader never disposes the <see cref="ModuleDefinition"/> behind the definition; the caller owns it. Disposing it closes
+        /// the file, but every access made while the definition is alive returns the same one, so only do that once nothing else
+        /// can still be using it. Otherwise, the file is closed once the definition is collected.
+        /// </para>
+        /// </remarks>
         /// <value>the Cecil definition for the plugin main type</value>
-        public TypeDefinition? PluginType { get; internal set; }
+        [Obsolete("Use TypeHandle instead.")]
+        public TypeDefinition? PluginType
+        {
+            get
+            {
+                if (TypeHandle is null) return null;
+                if (pluginType is not null && pluginType.TryGetTarget(out var cached))
+                    return cached;
+
+                var module = ModuleDefinition.ReadModule(File.FullName, new ReaderParameters
+                {
+                    ReadingMode = ReadingMode.Deferred,
+                    ReadWrite = false,
+                    AssemblyResolver = PluginTypeResolver
+                });
+                var type = module.LookupToken(TypeHandle.MetadataToken) as TypeDefinition;
+                if (type is not null)
+                    pluginType = new WeakReference<TypeDefinition>(type);
+                return type;
+            }
+        }
+
+        private WeakReference<TypeDefinition>? pluginType;
+
+        // the resolver holds nothing but its search directories, and modules don't dispose a resolver they were given,
+        // so every module read for PluginType shares this one
+        private static CecilLibLoader? pluginTypeResolver;
+
+        private static CecilLibLoader PluginTypeResolver
+            => LazyInitializer.EnsureInitialized(ref pluginTypeResolver, () =>
+            {
+                var resolver = new CecilLibLoader();
+                resolver.AddSearchDirectory(UnityGame.LibraryPath);
+                resolver.AddSearchDirectory(UnityGame.PluginsPath);
+                return resolver;
+            })!;
 
         /// <summary>
         /// The human readable name of the plugin.
@@ -148,6 +202,6 @@ namespace IPA.Loader
         /// Gets all of the metadata as a readable string.
         /// </summary>
         /// <returns>the readable printable metadata string</returns>
-        public override string ToString() => $"{Name}({Id}@{HVersion})({PluginType?.FullName}) from '{Utils.GetRelativePath(File?.FullName ?? "", UnityGame.InstallPath)}'";
+        public override string ToString() => $"{Name}({Id}@{HVersion})({TypeHandle?.FullName}) from '{Utils.GetRelativePath(File?.FullName ?? "", UnityGame.InstallPath)}'";
     }
 }
\ No newline at end of file
@@ -0,0 +1,371 @@
+﻿#nullable enable
+using IPA.Config;
+using IPA.Utilities;
+using Newtonsoft.Json;
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Reflection;
+using System.Text;
+using System.Threading;
+using Logger = IPA.Logging.Logger;
+
+namespace IPA.Loader
+{
+    /// <summary>
+    /// Records how much time each plugin spends in each part of its lifecycle, so that it's possible to tell which
+    /// plugins are slowing down the game's startup.
+    /// </summary>
+    /// <remarks>
+    /// <para>
+    /// Every sample records its wall time, and, where the runtime supports measuring them, the bytes allocated and the
+    /// time spent JIT compiling on the thread it ran on. Unity's Mono does not measure JIT time, so that is usually
+    /// <see langword="null"/>.
+    /// </para>
+    /// <para>
+    /// When the initial load finishes, a report of the slowest plugins is logged at the debug level. If
+    /// <c>Debug.ProfilePluginLoading</c> is set in the loader's config, or the game is started with
+    /// <c>--profile-load</c>, the full report is logged at the info level instead, and a trace that can be opened in
+    /// <c>chrome://tracing</c> is written to <c>Logs/PluginLoadTrace.json</c>.
+    /// </para>
+    /// </remarks>
+    public static class PluginProfiler
+    {
+        /// <summary>
+        /// The parts of a plugin's lifecycle that are measured.
+        /// </summary>
+        public enum Phase
+        {
+            /// <summary>
+            /// Reading the plugin's manifest and finding its plugin type.
+            /// </summary>
+            MetadataScan,
+            /// <summary>
+            /// Loading the plugin's assembly.
+            /// </summary>
+            AssemblyLoad,
+            /// <summary>
+            /// Finding the plugin's lifecycle methods and compiling the delegates that call them.
+            /// </summary>
+            ExecutorCompile,
+            /// <summary>
+            /// Calling <see cref="Features.Feature.BeforeInit(PluginMetadata)"/> on the plugin's features.
+            /// </summary>
+            FeatureBeforeInit,
+            /// <summary>
+            /// Constructing the plugin, and calling its <see cref="InitAttribute"/> methods.
+            /// </summary>
+            Init,
+            /// <summary>
+            /// Creating the features the plugin defines, and calling <see cref="Features.Feature.AfterInit(PluginMetadata, object)"/>
+            /// on its features.
+            /// </summary>
+            FeatureAfterInit,
+            /// <summary>
+            /// Calling the plugin's <see cref="OnEnableAttribute"/> and <see cref="OnStartAttribute"/> methods.
+            /// </summary>
+            /// <remarks>
+            /// For methods that return a <see cref="System.Threading.Tasks.Task"/>, only the time until they return
+            /// is included.
+            /// </remarks>
+            Enable,
+            /// <summary>
+            /// Calling the plugin's <see cref="OnDisableAttribute"/> and <see cref="OnExitAttribute"/> methods.
+            /// </summary>
+            /// <remarks>
+            /// For methods that return a <see cref="System.Threading.Tasks.Task"/>, only the time until they return
+            /// is included.
+            /// </remarks>
+            Disable,
+        }
+
+        /// <summary>
+        /// A single measurement of one plugin in one <see cref="Phase"/>.
+        /// </summary>
+        public sealed class Sample
+        {
+            /// <summary>
+            /// Gets the plugin that was measured.
+            /// </summary>
+            public PluginMetadata Plugin { get; }
+            /// <summary>
+            /// Gets the name of the plugin that was measured, or its file name if its manifest couldn't be read.
+            /// </summary>
+            public string PluginName { get; }
+            /// <summary>
+            /// Gets the phase that was measured.
+            /// </summary>
+            public Phase Phase { get; }
+            /// <summary>
+            /// Gets when the phase started, relative to when the profiler started.
+            /// </summary>
+            public TimeSpan Start { get; }
+            /// <summary>
+            /// Gets the wall time the phase took.
+            /// </summary>
+            public TimeSpan Duration { get; }
+            /// <summary>
+            /// Gets the number of bytes allocated on the measured thread during the phase, if the runtime can measure it.
+            /// </summary>
+            public long? AllocatedBytes { get; }
+            /// <summary>
+            /// Gets the time spent JIT compiling on the measured thread during the phase, if the runtime can measure it.
+            /// </summary>
+            public TimeSpan? JitTime { get; }
+            /// <summary>
+            /// Gets the managed ID of the thread the phase ran on.
+            /// </summary>
+            public int ThreadId { get; }
+
+            internal Sample(PluginMetadata plugin, string pluginName, Phase phase, TimeSpan start, TimeSpan duration,
+                long? allocatedBytes, TimeSpan? jitTime, int threadId)
+            {
+                Plugin = plugin;
+                PluginName = pluginName;
+                Phase = phase;
+                Start = start;
+                Duration = duration;
+                AllocatedBytes = allocatedBytes;
+                JitTime = jitTime;
+                ThreadId = threadId;
+            }
+        }
+
+        internal readonly struct Scope : IDisposable
+        {
+            private readonly PluginMetadata? plugin;
+            private readonly Phase phase;
+            private readonly long startTimestamp;
+            private readonly long startAllocated;
+            private readonly TimeSpan startJit;
+
+            public Scope(PluginMetadata plugin, Phase phase)
+            {
+                this.plugin = plugin;
+                this.phase = phase;
+                startAllocated = getAllocatedBytes?.Invoke() ?? 0;
+                startJit = getJitTime?.Invoke(true) ?? TimeSpan.Zero;
+                startTimestamp = Stopwatch.GetTimestamp(); // last, so that the measurement itself isn't included
+            }
+
+            public void Dispose()
+            {
+                if (plugin is null) return; // default instance
+
+                var end = Stopwatch.GetTimestamp();
+                long? allocated = getAllocatedBytes is null ? null : getAllocatedBytes() - startAllocated;
+                TimeSpan? jit = getJitTime is null ? null : getJitTime(true) - startJit;
+
+                Record(new Sample(plugin, GetName(plugin), phase,
+                    ToTimeSpan(startTimestamp - epoch), ToTimeSpan(end - startTimestamp),
+                    allocated, jit, Thread.CurrentThread.ManagedThreadId));
+            }
+        }
+
+        private static readonly long epoch = Stopwatch.GetTimestamp();
+        private static readonly object samplesLock = new();
+        private static readonly List<Sample> samples = new();
+
+        // both of these are only in newer runtimes, so find them if they're there
+        private static readonly Func<long>? getAllocatedBytes = CreateDelegate<Func<long>>(
+            typeof(GC).GetMethod("GetAllocatedBytesForCurrentThread", BindingFlags.Public | BindingFlags.Static, null, Type.EmptyTypes, null));
+        private static readonly Func<bool, TimeSpan>? getJitTime = CreateDelegate<Func<bool, TimeSpan>>(
+            Type.GetType("System.Runtime.JitInfo", false)?.GetMethod("GetCompilationTime", BindingFlags.Public | BindingFlags.Static, null, new[] { typeof(bool) }, null));
+
+        private static T? CreateDelegate<T>(MethodInfo? method) where T : Delegate
+        {
+            try
+            {
+                return method is null ? null : (T)Delegate.CreateDelegate(typeof(T), method);
+            }
+            catch (ArgumentException)
+            { // exists, but not with the signature we expect
+                return null;
+            }
+        }
+
+        /// <summary>
+        /// Gets whether the runtime can measure the bytes allocated during a phase.
+        /// </summary>
+        public static bool CanMeasureAllocations => getAllocatedBytes is not null;
+
+        /// <summary>
+        /// Gets whether the runtime can measure the time spent JIT compiling during a phase.
+        /// </summary>
+        public static bool CanMeasureJitTime => getJitTime is not null;
+
+        /// <summary>
+        /// Gets a snapshot of every sample recorded so far, in the order they finished.
+        /// </summary>
+        public static IReadOnlyList<Sample> Samples
+        {
+            get
+            {
+                lock (samplesLock)
+                    return samples.ToArray();
+            }
+        }
+
+        internal static Scope Measure(PluginMetadata plugin, Phase phase) => new(plugin, phase);
+
+        private static void Record(Sample sample)
+        {
+            lock (samplesLock)
+                samples.Add(sample);
+        }
+
+        /// <summary>
+        /// Forgets every sample recorded so far. Lets IPA.Tests start from nothing.
+        /// </summary>
+        internal static void Reset()
+        {
+            lock (samplesLock)
+                samples.Clear();
+        }
+
+        private static TimeSpan ToTimeSpan(long stopwatchTicks)
+            => TimeSpan.FromTicks((long)(stopwatchTicks * ((double)TimeSpan.TicksPerSecond / Stopwatch.Frequency)));
+
+        private static string GetName(PluginMetadata plugin)
+            => plugin.Manifest is not null ? plugin.Name : plugin.File?.Name ?? "<unknown>";
+
+        /// <summary>
+        /// Creates a report of the time each plugin spent in each phase, with the slowest plugins first.
+        /// </summary>
+        /// <param name="maxPlugins">the maximum number of plugins to include, or <c>0</c> to include all of them</param>
+        /// <returns>the report, as multiple lines of text</returns>
+        public static string GetReport(int maxPlugins = 0)
+        {
+            var byPlugin = Samples
+                .GroupBy(s => s.Plugin)
+                .Select(g => (Name: g.Last().PluginName, Samples: g.ToList(), Total: new TimeSpan(g.Sum(s => s.Duration.Ticks))))
+                .OrderByDescending(p => p.Total)
+                .ToList();
+
+            var sb = new StringBuilder();
+            _ = sb.Append("Plugin lifecycle profile (wall time");
+            if (CanMeasureAllocations) _ = sb.Append(", allocated");
+            if (CanMeasureJitTime) _ = sb.Append(", JIT time");
+            _ = sb.Append("), slowest first:");
+
+            foreach (var (name, pluginSamples, total) in maxPlugins > 0 ? byPlugin.Take(maxPlugins) : byPlugin)
+            {
+                _ = sb.AppendLine();
+                _ = sb.AppendFormat(CultureInfo.InvariantCulture, "  {0}: {1:0.0}ms", name, total.TotalMilliseconds);
+                if (CanMeasureAllocations)
+                    _ = sb.Append(", ").Append(FormatBytes(pluginSamples.Sum(s => s.AllocatedBytes ?? 0)));
+                if (CanMeasureJitTime)
+                    _ = sb.AppendFormat(CultureInfo.InvariantCulture, ", JIT {0:0.0}ms",
+                        new TimeSpan(pluginSamples.Sum(s => s.JitTime?.Ticks ?? 0)).TotalMilliseconds);
+
+                foreach (var phase in pluginSamples.GroupBy(s => s.Phase).OrderBy(g => g.Key))
+                {
+                    var time = new TimeSpan(phase.Sum(s => s.Duration.Ticks));
+                    _ = sb.AppendLine();
+                    _ = sb.AppendFormat(CultureInfo.InvariantCulture, "    {0}: {1:0.0}ms", phase.Key, time.TotalMilliseconds);
+                    if (phase.Count() > 1)
+                        _ = sb.AppendFormat(CultureInfo.InvariantCulture, " ({0} times)", phase.Count());
+                }
+            }
+
+            if (maxPlugins > 0 && byPlugin.Count > maxPlugins)
+            {
+                _ = sb.AppendLine();
+                _ = sb.AppendFormat(CultureInfo.InvariantCulture, "  ... and {0} more", byPlugin.Count - maxPlugins);
+            }
+
+            return sb.ToString();
+        }
+
+        private static string FormatBytes(long bytes)
+            => bytes >= 1024 * 1024
+                ? string.Format(CultureInfo.InvariantCulture, "{0:0.0}MiB", bytes / (1024.0 * 1024))
+                : string.Format(CultureInfo.InvariantCulture, "{0:0.0}KiB", bytes / 1024.0);
+
+        /// <summary>
+        /// Writes every sample recorded so far as a Chrome trace, which can be opened in <c>chrome://tracing</c> or
+        /// Perfetto.
+        /// </summary>
+        /// <param name="writer">the writer to write the trace to</param>
+        public static void WriteChromeTrace(TextWriter writer)
+        {
+            using var json = new JsonTextWriter(writer) { CloseOutput = false };
+
+            json.WriteStartObject();
+            json.WritePropertyName("displayTimeUnit");
+            json.WriteValue("ms");
+            json.WritePropertyName("traceEvents");
+            json.WriteStartArray();
+
+            foreach (var sample in Samples)
+            {
+                json.WriteStartObject();
+                json.WritePropertyName("name");
+                json.WriteValue(sample.PluginName);
+                json.WritePropertyName("cat");
+                json.WriteValue(sample.Phase.ToString());
+                json.WritePropertyName("ph");
+                json.WriteValue("X"); // a complete event, with a duration
+                json.WritePropertyName("ts");
+                json.WriteValue(sample.Start.Ticks / 10.0); // microseconds
+                json.WritePropertyName("dur");
+                json.WriteValue(sample.Duration.Ticks / 10.0);
+                json.WritePropertyName("pid");
+                json.WriteValue(1);
+                json.WritePropertyName("tid");
+                json.WriteValue(sample.ThreadId);
+
+                json.WritePropertyName("args");
+                json.WriteStartObject();
+                json.WritePropertyName("phase");
+                json.WriteValue(sample.Phase.ToString());
+                if (sample.AllocatedBytes is { } allocated)
+                {
+                    json.WritePropertyName("allocatedBytes");
+                    json.WriteValue(allocated);
+                }
+                if (sample.JitTime is { } jit)
+                {
+                    json.WritePropertyName("jitMs");
+                    json.WriteValue(jit.TotalMilliseconds);
+                }
+                json.WriteEndObject();
+
+                json.WriteEndObject();
+            }
+
+            json.WriteEndArray();
+            json.WriteEndObject();
+        }
+
+        internal static void ReportInitialLoad()
+        {
+            if (!SelfConfig.Debug_.ProfilePluginLoading_)
+            {
+                if (Logger.Loader.IsEnabled(Logger.Level.Debug)) // don't build a report nobody will see
+                    Logger.Loader.Debug(GetReport(10));
+                return;
+            }
+
+            Logger.Loader.Info(GetReport());
+
+            try
+            {
+                var logsDir = new DirectoryInfo("Logs");
+                logsDir.Create();
+                var path = Path.Combine(logsDir.FullName, "PluginLoadTrace.json");
+                using (var writer = new StreamWriter(path, false, new UTF8Encoding(false)))
+                    WriteChromeTrace(writer);
+                Logger.Loader.Info($"Wrote plugin load trace to {Utils.GetRelativePath(path, Environment.CurrentDirectory)}");
+            }
+            catch (Exception e) when (e is IOException or UnauthorizedAccessException)
+            {
+                Logger.Loader.Warn("Could not write plugin load trace");
+                Logger.Loader.Warn(e);
+            }
+        }
+    }
+}
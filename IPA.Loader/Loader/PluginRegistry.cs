@@ -0,0 +1,164 @@
+﻿#nullable enable
+using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using System.Linq;
+using System.Threading;
+
+namespace IPA.Loader
+{
+    /// <summary>
+    /// An immutable snapshot of which plugins are enabled and disabled, indexed for the queries that
+    /// <see cref="PluginManager"/> exposes.
+    /// </summary>
+    /// <remarks>
+    /// <para>
+    /// A new snapshot is published whenever the set of enabled plugins changes, with a higher <see cref="Version"/>.
+    /// Readers just take <see cref="Current"/>, so they never lock, and never see a half-applied change. The one exception is the
+    /// initial load, which adds each plugin to the current snapshot in place with <see cref="AddLoaded"/>.
+    /// </para>
+    /// <para>
+    /// Name and ID lookups return the first plugin with that name or ID in load order, like the linear searches
+    /// they replace did.
+    /// </para>
+    /// </remarks>
+    internal sealed class PluginRegistry
+    {
+        private static readonly object publishLock = new();
+        private static PluginRegistry current = new(0, Array.Empty<PluginExecutor>(), Array.Empty<PluginMetadata>());
+
+        /// <summary>
+        /// Gets the most recently published snapshot.
+        /// </summary>
+        public static PluginRegistry Current => Volatile.Read(ref current);
+
+        /// <summary>
+        /// Publishes a new snapshot of the given state.
+        /// </summary>
+        /// <param name="enabled">the executors of the enabled plugins, in load order</param>
+        /// <param name="disabled">the disabled plugins</param>
+        /// <returns>the new snapshot</returns>
+        public static PluginRegistry Publish(IEnumerable<PluginExecutor> enabled, IEnumerable<PluginMetadata> disabled)
+        {
+            lock (publishLock)
+            {
+                var next = new PluginRegistry(current.Version + 1, enabled.ToArray(), disabled.ToArray());
+                Volatile.Write(ref current, next);
+                return next;
+            }
+        }
+
+        /// <summary>
+        /// Adds a plugin that has just been initialized to <see cref="Current"/> in place, instead of publishing a new snapshot.
+        /// </summary>
+        /// <remarks>
+        /// This is only for the initial load, which runs on the main thread before anything but the plugins being loaded can look at
+        /// the registry, and would otherwise copy every plugin loaded so far for each one it adds. The <see cref="Version"/> doesn't
+        /// change. Once the load is done, a new snapshot has to be published, so that no snapshot is modified after that.
+        /// </remarks>
+        /// <param name="executor">the executor of the plugin, which comes after all enabled plugins in load order</param>
+        internal static void AddLoaded(PluginExecutor executor)
+        {
+            lock (publishLock)
+                current.Add(executor);
+        }
+
+        public long Version { get; }
+
+        public IReadOnlyList<PluginExecutor> Executors { get; }
+        public IReadOnlyList<PluginMetadata> Enabled { get; }
+        public IReadOnlyList<PluginMetadata> Disabled { get; }
+
+        // these are never modified once the snapshot is created, except by AddLoaded
+        internal HashSet<PluginMetadata> EnabledSet { get; }
+        internal HashSet<PluginMetadata> DisabledSet { get; }
+
+        private readonly List<PluginExecutor> executors;
+        private readonly List<PluginMetadata> enabled;
+        private readonly Dictionary<PluginMetadata, PluginExecutor> executorsByMeta = new();
+        private readonly Dictionary<string, PluginMetadata> enabledByName = new();
+        private readonly Dictionary<string, PluginMetadata> enabledById = new();
+        private readonly Dictionary<string, PluginMetadata> disabledByName = new();
+        private readonly Dictionary<string, PluginMetadata> disabledById = new();
+        private readonly Dictionary<PluginMetadata, List<PluginMetadata>> dependents = new();
+
+        private PluginRegistry(long version, PluginExecutor[] executors, PluginMetadata[] disabled)
+        {
+            Version = version;
+            this.executors = new List<PluginExecutor>(executors.Length);
+            enabled = new List<PluginMetadata>(executors.Length);
+            Executors = new ReadOnlyCollection<PluginExecutor>(this.executors);
+            Enabled = new ReadOnlyCollection<PluginMetadata>(enabled);
+            Disabled = new ReadOnlyCollection<PluginMetadata>(disabled);
+            EnabledSet = new HashSet<PluginMetadata>();
+            DisabledSet = new HashSet<PluginMetadata>(disabled);
+
+            foreach (var executor in executors)
+                Add(executor);
+
+            foreach (var meta in disabled)
+            {
+                AddFirst(disabledByName, meta.Name, meta);
+                AddFirst(disabledById, meta.Id, meta);
+            }
+            foreach (var meta in DisabledSet)
+                AddDependents(meta);
+        }
+
+        private void Add(PluginExecutor executor)
+        {
+            var meta = executor.Metadata;
+            executors.Add(executor);
+            enabled.Add(meta);
+            if (!executorsByMeta.ContainsKey(meta))
+                executorsByMeta.Add(meta, executor);
+            AddFirst(enabledByName, meta.Name, meta);
+            AddFirst(enabledById, meta.Id, meta);
+            if (EnabledSet.Add(meta))
+                AddDependents(meta);
+        }
+
+        private void AddDependents(PluginMetadata meta)
+        {
+            foreach (var dep in meta.Dependencies)
+            {
+                if (!dependents.TryGetValue(dep, out var list))
+                    dependents.Add(dep, list = new List<PluginMetadata>());
+                list.Add(meta);
+            }
+        }
+
+        private static void AddFirst(Dictionary<string, PluginMetadata> index, string? key, PluginMetadata meta)
+        {
+            if (key != null && !index.ContainsKey(key))
+                index.Add(key, meta);
+        }
+
+        private static PluginMetadata? Find(Dictionary<string, PluginMetadata> index, string? key)
+            => key != null && index.TryGetValue(key, out var meta) ? meta : null;
+
+        public PluginMetadata? GetEnabledByName(string? name) => Find(enabledByName, name);
+        public PluginMetadata? GetEnabledById(string? id) => Find(enabledById, id);
+        public PluginMetadata? GetDisabledByName(string? name) => Find(disabledByName, name);
+        public PluginMetadata? GetDisabledById(string? id) => Find(disabledById, id);
+
+        public bool IsEnabled(PluginMetadata meta) => EnabledSet.Contains(meta);
+        public bool IsDisabled(PluginMetadata meta) => DisabledSet.Contains(meta);
+
+        public bool TryGetExecutor(PluginMetadata meta, out PluginExecutor executor)
+            => executorsByMeta.TryGetValue(meta, out executor!);
+
+        /// <summary>
+        /// Gets the plugins, enabled or disabled, that directly depend on <paramref name="meta"/>.
+        /// </summary>
+        public IReadOnlyList<PluginMetadata> GetDependents(PluginMetadata meta)
+            => dependents.TryGetValue(meta, out var list) ? list : Array.Empty<PluginMetadata>();
+
+        /// <summary>
+        /// Checks whether <paramref name="other"/> has the same plugins enabled and disabled as this snapshot.
+        /// </summary>
+        public bool HasSameState(PluginRegistry other)
+            => other == this
+            || (other.EnabledSet.SetEquals(EnabledSet) && other.DisabledSet.SetEquals(DisabledSet));
+    }
+}
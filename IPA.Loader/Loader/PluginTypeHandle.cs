@@ -0,0 +1,79 @@
+﻿#nullable enable
+using Mono.Cecil;
+using System;
+using System.Reflection;
+
+namespace IPA.Loader
+{
+    /// <summary>
+    /// Identifies the main type of a plugin, without keeping its assembly's metadata in memory.
+    /// </summary>
+    /// <remarks>
+    /// This is all that is kept of the Cecil type the loader finds during discovery. The modules it was read from are
+    /// disposed once discovery is done.
+    /// </remarks>
+    public sealed class PluginTypeHandle
+    {
+        /// <summary>
+        /// The full name of the type, in the form used by Cecil.
+        /// </summary>
+        /// <value>the full name of the type</value>
+        public string FullName { get; }
+
+        /// <summary>
+        /// The namespace of the type.
+        /// </summary>
+        /// <value>the namespace of the type</value>
+        public string Namespace { get; }
+
+        /// <summary>
+        /// The name of the type, without its namespace.
+        /// </summary>
+        /// <value>the name of the type</value>
+        public string Name { get; }
+
+        /// <summary>
+        /// The metadata token of the type in its module.
+        /// </summary>
+        /// <value>the metadata token of the type</value>
+        public int MetadataToken { get; }
+
+        /// <summary>
+        /// The identity of the assembly that contains the type.
+        /// </summary>
+        /// <value>the full name of the assembly containing the type</value>
+        public string AssemblyName { get; }
+
+        internal PluginTypeHandle(TypeDefinition type)
+        {
+            FullName = type.FullName;
+            Namespace = type.Namespace;
+            Name = type.Name;
+            MetadataToken = type.MetadataToken.ToInt32();
+            AssemblyName = type.Module.Assembly.FullName;
+        }
+
+        /// <summary>
+        /// Gets the runtime type this handle refers to in <paramref name="assembly"/>.
+        /// </summary>
+        /// <param name="assembly">the loaded plugin assembly</param>
+        /// <returns>the <see cref="Type"/> this handle refers to, or <see langword="null"/> if it could not be found</returns>
+        public Type? Resolve(Assembly assembly)
+        {
+            try
+            {
+                var type = assembly.ManifestModule.ResolveType(MetadataToken);
+                if (type.FullName == FullName.Replace('/', '+'))
+                    return type;
+            }
+            catch (ArgumentException)
+            { // the token is not valid in this module, so fall back to the name
+            }
+
+            return assembly.GetType(FullName.Replace('/', '+'));
+        }
+
+        /// <inheritdoc/>
+        public override string ToString() => FullName;
+    }
+}
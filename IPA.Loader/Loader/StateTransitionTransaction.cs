@@ -11,16 +11,19 @@ namespace IPA.Loader
     /// </summary>
     public sealed class StateTransitionTransaction : IDisposable
     {
+        // the state this transaction is based on; its sets are shared, and never modified
+        private readonly PluginRegistry baseState;
         private readonly HashSet<PluginMetadata> currentlyEnabled;
         private readonly HashSet<PluginMetadata> currentlyDisabled;
         private readonly HashSet<PluginMetadata> toEnable = new ();
         private readonly HashSet<PluginMetadata> toDisable = new ();
         private bool stateChanged;
 
-        internal StateTransitionTransaction(IEnumerable<PluginMetadata> enabled, IEnumerable<PluginMetadata> disabled)
+        internal StateTransitionTransaction(PluginRegistry state)
         {
-            currentlyEnabled = new HashSet<PluginMetadata>(enabled.ToArray());
-            currentlyDisabled = new HashSet<PluginMetadata>(disabled.ToArray());
+            baseState = state;
+            currentlyEnabled = state.EnabledSet;
+            currentlyDisabled = state.DisabledSet;
         }
 
         /// <summary>
@@ -39,8 +42,7 @@ namespace IPA.Loader
         /// <exception cref="ObjectDisposedException">if this object has been disposed</exception>
         public bool HasStateChanged => ThrowIfDisposed<bool>() || stateChanged;
 
-        internal IEnumerable<PluginMetadata> CurrentlyEnabled => currentlyEnabled;
-        internal IEnumerable<PluginMetadata> CurrentlyDisabled => currentlyDisabled;
+        internal PluginRegistry BaseState => baseState;
         internal IEnumerable<PluginMetadata> ToEnable => toEnable;
         internal IEnumerable<PluginMetadata> ToDisable => toDisable;
 
@@ -128,7 +130,7 @@ namespace IPA.Loader
             disabledDeps = null;
             if (IsEnabledInternal(meta)) return false;
 
-            var needsEnabled = meta.Dependencies.Where(m => DisabledPluginsInternal.Contains(m)).ToArray();
+            var needsEnabled = meta.Dependencies.Where(IsDisabledInternal).ToArray();
             if (autoDeps)
             {
                 foreach (var dep in needsEnabled)
@@ -186,7 +188,7 @@ namespace IPA.Loader
             enabledDependents = null;
             if (IsDisabledInternal(meta)) return false;
 
-            var needsDisabled = EnabledPluginsInternal.Where(m => m.Dependencies.Contains(meta)).ToArray();
+            var needsDisabled = baseState.GetDependents(meta).Where(IsEnabledInternal).ToArray();
             if (autoDependents)
             {
                 foreach (var dep in needsDisabled)
@@ -229,14 +231,21 @@ namespace IPA.Loader
         /// If you are running in a coroutine, you can use <see cref="Utilities.Async.Coroutines.WaitForTask(Task)"/> instead of <see langword="await"/>.
         /// </para>
         /// <para>
-        /// If you are running on the Unity main thread, this will block until all enabling is done, and will return a task representing the disables.
-        /// Otherwise, the task returned represents both, and <i>will not complete</i> until Unity has done (possibly) several updates, depending on
-        /// the number of plugins being disabled, and the time they take.
+        /// Plugins that don't depend on each other are disabled concurrently. A plugin is only enabled once the plugins it depends on have
+        /// finished enabling. If you are running on the Unity main thread, every plugin whose dependencies don't have asynchronous enable
+        /// methods is enabled before this returns. The rest are enabled later, on the main thread, as their dependencies finish. Otherwise,
+        /// all of it happens on the main thread later, and the task <i>will not complete</i> until Unity has done (possibly) several updates.
+        /// </para>
+        /// <para>
+        /// <b>This differs from earlier versions</b>, where the returned task only represented the disables. It now also represents the
+        /// enables, including asynchronous enable methods, so it does not complete until those have. Errors from enabling plugins are still
+        /// only logged, and don't fault the task.
         /// </para>
         /// </remarks>
-        /// <returns>a <see cref="Task"/> which completes whenever all disables complete</returns>
+        /// <returns>a <see cref="Task"/> which completes whenever all enables and disables complete</returns>
         /// <exception cref="ObjectDisposedException">if this object has been disposed</exception>
-        /// <exception cref="InvalidOperationException">if the plugins' state no longer matches this transaction's original state</exception>
+        /// <exception cref="InvalidOperationException">if the plugins' state no longer matches this transaction's original state, or
+        /// if an earlier transaction is still enabling or disabling any of the plugins this one changes</exception>
         public Task Commit() => ThrowIfDisposed<Task>() ?? PluginManager.CommitTransaction(this);
 
         /// <summary>
@@ -247,7 +256,7 @@ namespace IPA.Loader
         public StateTransitionTransaction Clone()
         {
             ThrowIfDisposed();
-            var copy = new StateTransitionTransaction(CurrentlyEnabled, CurrentlyDisabled);
+            var copy = new StateTransitionTransaction(baseState);
             foreach (var toEnable in ToEnable)
                 _ = copy.toEnable.Add(toEnable);
             foreach (var toDisable in ToDisable)
@@ -0,0 +1,129 @@
+﻿#nullable enable
+using System;
+using System.Threading;
+
+namespace IPA.Logging
+{
+    /// <summary>
+    /// A single message queued to be printed by a <see cref="StandardLogger"/>.
+    /// </summary>
+    /// <seealso cref="LogPrinter.Print(ArraySegment{LogMessage})"/>
+    public readonly struct LogMessage
+    {
+        /// <summary>
+        /// Gets the level of the message.
+        /// </summary>
+        /// <value>the message level</value>
+        public Logger.Level Level { get; }
+
+        /// <summary>
+        /// Gets the time the message was composed.
+        /// </summary>
+        /// <value>the time the message was composed</value>
+        public DateTime Time { get; }
+
+        /// <summary>
+        /// Gets the name of the log that created this message.
+        /// </summary>
+        /// <value>the name of the source log</value>
+        public string LogName { get; }
+
+        /// <summary>
+        /// Gets the text of the message.
+        /// </summary>
+        /// <remarks>
+        /// Messages logged with a template are rendered once by the log thread, before they are passed to any printer.
+        /// </remarks>
+        /// <value>the message</value>
+        public string Message => content as string ?? ((DeferredMessage)content).Render();
+
+        // either the message string, or a DeferredMessage to be rendered on the log thread
+        private readonly object content;
+
+        internal StandardLogger Source { get; }
+        internal ManualResetEventSlim? Sync { get; }
+
+        internal LogMessage(Logger.Level level, DateTime time, StandardLogger source, string logName, object content, ManualResetEventSlim? sync)
+        {
+            Level = level;
+            Time = time;
+            Source = source;
+            LogName = logName;
+            this.content = content;
+            Sync = sync;
+        }
+
+        /// <summary>
+        /// Gets a copy of this message with any deferred formatting already done.
+        /// </summary>
+        internal LogMessage Rendered()
+        {
+            if (content is not DeferredMessage deferred)
+                return this;
+
+            string text;
+            try
+            {
+                text = deferred.Render();
+            }
+            catch (Exception e)
+            { // a bad template shouldn't take down the printers
+                text = $"{deferred.Format} (formatting failed: {e.Message})";
+            }
+
+            return new(Level, Time, Source, LogName, text, Sync);
+        }
+    }
+
+    /// <summary>
+    /// A log message template and its arguments, which is only formatted when it is printed.
+    /// </summary>
+    internal abstract class DeferredMessage
+    {
+        public readonly string Format;
+
+        protected DeferredMessage(string format) => Format = format;
+
+        public abstract string Render();
+    }
+
+    internal sealed class DeferredMessage<T1> : DeferredMessage
+    {
+        private readonly T1 arg1;
+
+        public DeferredMessage(string format, T1 arg1) : base(format)
+            => this.arg1 = arg1;
+
+        public override string Render() => string.Format(Format, arg1);
+    }
+
+    internal sealed class DeferredMessage<T1, T2> : DeferredMessage
+    {
+        private readonly T1 arg1;
+        private readonly T2 arg2;
+
+        public DeferredMessage(string format, T1 arg1, T2 arg2) : base(format)
+        {
+            this.arg1 = arg1;
+            this.arg2 = arg2;
+        }
+
+        public override string Render() => string.Format(Format, arg1, arg2);
+    }
+
+    internal sealed class DeferredMessage<T1, T2, T3> : DeferredMessage
+    {
+        private readonly T1 arg1;
+        private readonly T2 arg2;
+        private readonly T3 arg3;
+
+        public DeferredMessage(string format, T1 arg1, T2 arg2, T3 arg3) : base(format)
+        {
+            this.arg1 = arg1;
+            this.arg2 = arg2;
+            this.arg3 = arg3;
+        }
+
+        public override string Render() => string.Format(Format, arg1, arg2, arg3);
+    }
+}
@@ -11,6 +11,10 @@ namespace IPA.Logging
         /// <summary>
         /// Provides a filter for which log levels to allow through.
         /// </summary>
+        /// <remarks>
+        /// This is read every time a <see cref="StandardLogger"/> checks whether a level is enabled, so changes take effect
+        /// immediately.
+        /// </remarks>
         /// <value>the level to filter to</value>
         public abstract Logger.LogLevel Filter { get; set; }
 
@@ -23,6 +27,25 @@ namespace IPA.Logging
         /// <param name="message">the message</param>
         public abstract void Print(Logger.Level level, DateTime time, string logName, string message);
 
+        /// <summary>
+        /// Prints a batch of messages, in order. All messages in a batch come from the same log and have the same level.
+        /// </summary>
+        /// <remarks>
+        /// The default implementation calls <see cref="Print(Logger.Level, DateTime, string, string)"/> for each message.
+        /// Override this to amortize per-message work, like flushes, across the batch.
+        /// </remarks>
+        /// <param name="messages">the messages to print</param>
+        public virtual void Print(ArraySegment<LogMessage> messages)
+        {
+            var arr = messages.Array;
+            var end = messages.Offset + messages.Count;
+            for (var i = messages.Offset; i < end; i++)
+            {
+                var msg = arr[i];
+                Print(msg.Level, msg.Time, msg.LogName, msg.Message);
+            }
+        }
+
         /// <summary>
         /// Called before the first print in a group. May be called multiple times.
         /// Use this to create file handles and the like.
@@ -35,6 +58,12 @@ namespace IPA.Logging
         /// </summary>
         public virtual void EndPrint() { }
 
+        /// <summary>
+        /// The levels that this printer will actually print, used to skip formatting messages nothing will print.
+        /// </summary>
+        internal virtual Logger.LogLevel AcceptedLevels => Filter;
+
         internal DateTime LastUse { get; set; }
+        internal bool Started { get; set; }
     }
 }
\ No newline at end of file
@@ -192,6 +192,74 @@ namespace IPA.Logging
         /// <param name="e">the exception to log</param>
         public virtual void Log(Level level, Exception e) => Log(level, e.ToString());
 
+        /// <summary>
+        /// Checks whether or not a message at <paramref name="level"/> would actually be printed anywhere.
+        /// </summary>
+        /// <remarks>
+        /// Use this to skip building expensive log messages. The templated overloads of <see cref="Log{T1}(Level, string, T1)"/>,
+        /// <see cref="Trace{T1}(string, T1)"/>, and <see cref="Debug{T1}(string, T1)"/> already check this before formatting.
+        /// </remarks>
+        /// <param name="level">the level to check</param>
+        /// <returns><see langword="true"/> if a message at <paramref name="level"/> may be printed, <see langword="false"/> otherwise</returns>
+        public virtual bool IsEnabled(Level level) => true;
+
+        /// <summary>
+        /// Logs a message built from a composite format string and one argument.
+        /// </summary>
+        /// <remarks>
+        /// The message is only formatted (with <see cref="string.Format(string, object)"/>) if <see cref="IsEnabled(Level)"/> is
+        /// <see langword="true"/>, and loggers may defer that formatting until the message is actually printed.
+        /// </remarks>
+        /// <typeparam name="T1">the type of the first argument</typeparam>
+        /// <param name="level">the level of the message</param>
+        /// <param name="format">the composite format string</param>
+        /// <param name="arg1">the first argument to format</param>
+        public virtual void Log<T1>(Level level, string format, T1 arg1)
+        {
+            if (IsEnabled(level))
+                Log(level, string.Format(format, arg1));
+        }
+
+        /// <summary>
+        /// Logs a message built from a composite format string and two arguments.
+        /// </summary>
+        /// <remarks>
+        /// The message is only formatted if <see cref="IsEnabled(Level)"/> is <see langword="true"/>, and loggers may defer
+        /// that formatting until the message is actually printed.
+        /// </remarks>
+        /// <typeparam name="T1">the type of the first argument</typeparam>
+        /// <typeparam name="T2">the type of the second argument</typeparam>
+        /// <param name="level">the level of the message</param>
+        /// <param name="format">the composite format string</param>
+        /// <param name="arg1">the first argument to format</param>
+        /// <param name="arg2">the second argument to format</param>
+        public virtual void Log<T1, T2>(Level level, string format, T1 arg1, T2 arg2)
+        {
+            if (IsEnabled(level))
+                Log(level, string.Format(format, arg1, arg2));
+        }
+
+        /// <summary>
+        /// Logs a message built from a composite format string and three arguments.
+        /// </summary>
+        /// <remarks>
+        /// The message is only formatted if <see cref="IsEnabled(Level)"/> is <see langword="true"/>, and loggers may defer
+        /// that formatting until the message is actually printed.
+        /// </remarks>
+        /// <typeparam name="T1">the type of the first argument</typeparam>
+        /// <typeparam name="T2">the type of the second argument</typeparam>
+        /// <typeparam name="T3">the type of the third argument</typeparam>
+        /// <param name="level">the level of the message</param>
+        /// <param name="format">the composite format string</param>
+        /// <param name="arg1">the first argument to format</param>
+        /// <param name="arg2">the second argument to format</param>
+        /// <param name="arg3">the third argument to format</param>
+        public virtual void Log<T1, T2, T3>(Level level, string format, T1 arg1, T2 arg2, T3 arg3)
+        {
+            if (IsEnabled(level))
+                Log(level, string.Format(format, arg1, arg2, arg3));
+        }
+
         /// <summary>
         /// Sends a trace message.
         /// Equivalent to <c>Log(Level.Trace, message);</c>
@@ -208,6 +276,42 @@ namespace IPA.Logging
         /// <param name="e">the exception to log</param>
         public virtual void Trace(Exception e) => Log(Level.Trace, e);
 
+        /// <summary>
+        /// Sends a templated trace message, which is only formatted if trace messages are printed.
+        /// Equivalent to <c>Log(Level.Trace, format, arg1);</c>
+        /// </summary>
+        /// <seealso cref="Log{T1}(Level, string, T1)"/>
+        /// <typeparam name="T1">the type of the first argument</typeparam>
+        /// <param name="format">the composite format string</param>
+        /// <param name="arg1">the first argument to format</param>
+        public void Trace<T1>(string format, T1 arg1) => Log(Level.Trace, format, arg1);
+
+        /// <summary>
+        /// Sends a templated trace message, which is only formatted if trace messages are printed.
+        /// Equivalent to <c>Log(Level.Trace, format, arg1, arg2);</c>
+        /// </summary>
+        /// <seealso cref="Log{T1, T2}(Level, string, T1, T2)"/>
+        /// <typeparam name="T1">the type of the first argument</typeparam>
+        /// <typeparam name="T2">the type of the second argument</typeparam>
+        /// <param name="format">the composite format string</param>
+        /// <param name="arg1">the first argument to format</param>
+        /// <param name="arg2">the second argument to format</param>
+        public void Trace<T1, T2>(string format, T1 arg1, T2 arg2) => Log(Level.Trace, format, arg1, arg2);
+
+        /// <summary>
+        /// Sends a templated trace message, which is only formatted if trace messages are printed.
+        /// Equivalent to <c>Log(Level.Trace, format, arg1, arg2, arg3);</c>
+        /// </summary>
+        /// <seealso cref="Log{T1, T2, T3}(Level, string, T1, T2, T3)"/>
+        /// <typeparam name="T1">the type of the first argument</typeparam>
+        /// <typeparam name="T2">the type of the second argument</typeparam>
+        /// <typeparam name="T3">the type of the third argument</typeparam>
+        /// <param name="format">the composite format string</param>
+        /// <param name="arg1">the first argument to format</param>
+        /// <param name="arg2">the second argument to format</param>
+        /// <param name="arg3">the third argument to format</param>
+        public void Trace<T1, T2, T3>(string format, T1 arg1, T2 arg2, T3 arg3) => Log(Level.Trace, format, arg1, arg2, arg3);
+
         /// <summary>
         /// Sends a debug message.
         /// Equivalent to <c>Log(Level.Debug, message);</c>
@@ -224,6 +328,42 @@ namespace IPA.Logging
         /// <param name="e">the exception to log</param>
         public virtual void Debug(Exception e) => Log(Level.Debug, e);
 
+        /// <summary>
+        /// Sends a templated debug message, which is only formatted if debug messages are printed.
+        /// Equivalent to <c>Log(Level.Debug, format, arg1);</c>
+        /// </summary>
+        /// <seealso cref="Log{T1}(Level, string, T1)"/>
+        /// <typeparam name="T1">the type of the first argument</typeparam>
+        /// <param name="format">the composite format string</param>
+        /// <param name="arg1">the first argument to format</param>
+        public void Debug<T1>(string format, T1 arg1) => Log(Level.Debug, format, arg1);
+
+        /// <summary>
+        /// Sends a templated debug message, which is only formatted if debug messages are printed.
+        /// Equivalent to <c>Log(Level.Debug, format, arg1, arg2);</c>
+        /// </summary>
+        /// <seealso cref="Log{T1, T2}(Level, string, T1, T2)"/>
+        /// <typeparam name="T1">the type of the first argument</typeparam>
+        /// <typeparam name="T2">the type of the second argument</typeparam>
+        /// <param name="format">the composite format string</param>
+        /// <param name="arg1">the first argument to format</param>
+        /// <param name="arg2">the second argument to format</param>
+        public void Debug<T1, T2>(string format, T1 arg1, T2 arg2) => Log(Level.Debug, format, arg1, arg2);
+
+        /// <summary>
+        /// Sends a templated debug message, which is only formatted if debug messages are printed.
+        /// Equivalent to <c>Log(Level.Debug, format, arg1, arg2, arg3);</c>
+        /// </summary>
+        /// <seealso cref="Log{T1, T2, T3}(Level, string, T1, T2, T3)"/>
+        /// <typeparam name="T1">the type of the first argument</typeparam>
+        /// <typeparam name="T2">the type of the second argument</typeparam>
+        /// <typeparam name="T3">the type of the third argument</typeparam>
+        /// <param name="format">the composite format string</param>
+        /// <param name="arg1">the first argument to format</param>
+        /// <param name="arg2">the second argument to format</param>
+        /// <param name="arg3">the third argument to format</param>
+        public void Debug<T1, T2, T3>(string format, T1 arg1, T2 arg2, T3 arg3) => Log(Level.Debug, format, arg1, arg2, arg3);
+
         /// <summary>
         /// Sends an info message.
         /// Equivalent to <c>Log(Level.Info, message);</c>
@@ -15,7 +15,18 @@ namespace IPA.Logging.Printers
         /// A filter for this specific printer.
         /// </summary>
         /// <value>the filter to apply to this printer</value>
-        public override Logger.LogLevel Filter { get => filter; set => filter = value; }
+        public override Logger.LogLevel Filter
+        {
+            get => filter;
+            set
+            {
+                filter = value;
+                StandardLogger.PrintersChanged(); // loggers cache which levels their printers accept
+            }
+        }
+
+        internal override Logger.LogLevel AcceptedLevels => Filter & StandardLogger.PrintFilter;
+
         /// <summary>
         /// The color to print messages as.
         /// </summary>
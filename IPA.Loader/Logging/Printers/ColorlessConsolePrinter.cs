@@ -7,11 +7,23 @@ namespace IPA.Logging.Printers
     /// </summary>
     public class ColorlessConsolePrinter : LogPrinter
     {
+        private Logger.LogLevel filter;
+
         /// <summary>
         /// A filter for this specific printer.
         /// </summary>
         /// <value>the filter level for this printer</value>
-        public override Logger.LogLevel Filter { get; set; }
+        public override Logger.LogLevel Filter
+        {
+            get => filter;
+            set
+            {
+                filter = value;
+                StandardLogger.PrintersChanged(); // loggers cache which levels their printers accept
+            }
+        }
+
+        internal override Logger.LogLevel AcceptedLevels => Filter & StandardLogger.PrintFilter;
 
         /// <summary>
         /// Prints an entry to standard out.
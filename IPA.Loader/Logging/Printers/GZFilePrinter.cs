@@ -1,17 +1,35 @@
 ﻿#nullable enable
+using IPA.Utilities;
 using Ionic.Zlib;
 using System;
 using System.Diagnostics.CodeAnalysis;
+using System.Collections.Generic;
 using System.IO;
+using System.Linq;
 using System.Runtime.InteropServices;
 using System.Text;
 using System.Text.RegularExpressions;
+using System.Threading;
 
 namespace IPA.Logging.Printers
 {
     /// <summary>
     /// A <see cref="LogPrinter"/> abstract class that provides the utilities to write to a GZip file.
     /// </summary>
+    /// <remarks>
+    /// <para>
+    /// Logs are compressed as they are written, at a fast compression level. A GZip member stays open across print sessions
+    /// that follow each other closely, so that the compressor keeps its dictionary. The compressor is sync-flushed at the end of
+    /// every print session, and every <see cref="FlushInterval"/> during long ones, so everything up to that point can be read
+    /// back even if the game crashes. The member is finished, and the file closed, once nothing has been printed to it for
+    /// <see cref="FlushInterval"/>, when the file is rotated, or when the log thread shuts down. Printing after that appends
+    /// a new member to the same file.
+    /// </para>
+    /// <para>
+    /// A new file is started once the current one grows past <see cref="MaxFileSize"/>, and old logs in the same directory are
+    /// deleted once they are older than <see cref="MaxLogAge"/>, except for the newest <see cref="MinLogsKept"/>.
+    /// </para>
+    /// </remarks>
     public abstract class GZFilePrinter : LogPrinter, IDisposable
     {
         [DllImport("Kernel32.dll", CharSet = CharSet.Unicode, SetLastError = true)]
@@ -25,6 +43,9 @@ namespace IPA.Logging.Printers
 
         internal static Regex removeControlCodes = new("\x1b\\[\\d+m", reOptions);
 
+        private static readonly object openPrintersLock = new();
+        private static readonly List<GZFilePrinter> openPrinters = new();
+
         private FileInfo? fileInfo;
 
         /// <summary>
@@ -34,52 +55,88 @@ namespace IPA.Logging.Printers
         protected StreamWriter? FileWriter;
 
         private FileStream? fstream;
+        private GZipStream? gzstream;
+        private DateTime lastFlush;
+        private DateTime lastPrint;
+        private bool hasUnflushedData;
 
         /// <summary>
         /// Gets the <see cref="FileInfo"/> for the file to write to.
         /// </summary>
+        /// <remarks>
+        /// The file actually written is this file with <c>.gz</c> appended to its name.
+        /// </remarks>
         /// <returns>the file to write to</returns>
         protected abstract FileInfo GetFileInfo();
 
+        /// <summary>
+        /// Gets the compressed size that a log file may grow to before a new one is started.
+        /// </summary>
+        /// <value>the maximum size of a single log file, in bytes</value>
+        protected virtual long MaxFileSize => 32 * 1024 * 1024;
+
+        /// <summary>
+        /// Gets the age after which old logs are deleted.
+        /// </summary>
+        /// <value>the maximum age of a log file</value>
+        protected virtual TimeSpan MaxLogAge => TimeSpan.FromDays(30);
+
+        /// <summary>
+        /// Gets the number of most recent logs that are always kept, regardless of their age.
+        /// </summary>
+        /// <value>the minimum number of log files to keep</value>
+        protected virtual int MinLogsKept => 10;
+
+        /// <summary>
+        /// Gets the maximum time that written messages may stay buffered in the compressor.
+        /// </summary>
+        /// <remarks>
+        /// This is also how long the file stays open after the last message printed to it.
+        /// </remarks>
+        /// <value>the time between sync flushes during a print session</value>
+        protected virtual TimeSpan FlushInterval => TimeSpan.FromSeconds(1);
+
         private const string latestFormat = "_latest{0}";
+        private const string compressedExtension = ".gz";
+        private const int writerBufferSize = 16 * 1024;
 
         [MemberNotNull(nameof(fileInfo))]
         private void InitLog()
         {
             try
             {
-                if (fileInfo == null)
-                { // first init
-                    fileInfo = GetFileInfo();
-                    var ext = fileInfo.Extension;
+                if (fileInfo != null)
+                {
+                    fileInfo.Refresh();
+                    if (!fileInfo.Exists || fileInfo.Length < MaxFileSize)
+                        return;
+                    // otherwise rotate to a new file
+                }
 
-                    var symlink = new FileInfo(Path.Combine(fileInfo.DirectoryName ?? throw new InvalidOperationException(), string.Format(latestFormat, ext)));
-                    if (symlink.Exists) symlink.Delete();
+                var baseInfo = GetFileInfo();
+                var dir = baseInfo.Directory ?? throw new InvalidOperationException();
+                fileInfo = new FileInfo(baseInfo.FullName + compressedExtension);
 
-                    foreach (var file in fileInfo.Directory.EnumerateFiles("*.log", SearchOption.TopDirectoryOnly))
-                    {
-                        if (file.Equals(fileInfo)) continue;
-                        if (file.Extension == ".gz") continue;
+                var symlink = new FileInfo(Path.Combine(dir.FullName, string.Format(latestFormat, baseInfo.Extension + compressedExtension)));
+                if (symlink.Exists) symlink.Delete();
 
-                        CompressOldLog(file);
-                    }
+                DeleteOldLogs(dir, fileInfo);
 
-                    fileInfo.Create().Close();
+                using (fileInfo.Open(FileMode.Append, FileAccess.Write, FileShare.ReadWrite)) { }
 
-                    try
-                    {
-                        if (!CreateHardLink(symlink.FullName, fileInfo.FullName, IntPtr.Zero))
-                        {
-                            var error = Marshal.GetLastWin32Error();
-                            Logger.Default.Error($"Hardlink creation failed ({error})");
-                        }
-                    }
-                    catch (Exception e)
+                try
+                {
+                    if (!CreateHardLink(symlink.FullName, fileInfo.FullName, IntPtr.Zero))
                     {
-                        Logger.Default.Error("Error creating latest hardlink!");
-                        Logger.Default.Error(e);
+                        var error = Marshal.GetLastWin32Error();
+                        Logger.Default.Error($"Hardlink creation failed ({error})");
                     }
                 }
+                catch (Exception e)
+                {
+                    Logger.Default.Error("Error creating latest hardlink!");
+                    Logger.Default.Error(e);
+                }
             }
             catch (Exception e)
             {
@@ -89,24 +146,31 @@ namespace IPA.Logging.Printers
             }
         }
 
-        private static async void CompressOldLog(FileInfo file)
+        private static bool IsLogFile(FileInfo file)
+            => !file.Name.StartsWith(string.Format(latestFormat, ""), StringComparison.Ordinal)
+            && (file.Name.EndsWith(".log", StringComparison.OrdinalIgnoreCase)
+             || file.Name.EndsWith(".log" + compressedExtension, StringComparison.OrdinalIgnoreCase));
+
+        private void DeleteOldLogs(DirectoryInfo dir, FileInfo current)
         {
+            var cutoff = Utils.CurrentTime() - MaxLogAge;
             try
             {
-                Logger.Default.Debug($"Compressing log file {file}");
+                var toDelete = dir.EnumerateFiles("*", SearchOption.TopDirectoryOnly)
+                    .Where(f => IsLogFile(f) && f.FullName != current.FullName)
+                    .OrderByDescending(f => f.LastWriteTime)
+                    .Skip(Math.Max(0, MinLogsKept - 1)) // the current log counts as one of them
+                    .Where(f => f.LastWriteTime < cutoff);
 
-                var newFile = new FileInfo(file.FullName + ".gz");
-
-                using (var istream = file.OpenRead())
-                using (var ostream = newFile.Create())
-                using (var gz = new GZipStream(ostream, CompressionMode.Compress, CompressionLevel.BestCompression, false))
-                    await istream.CopyToAsync(gz).ConfigureAwait(false);
-
-                file.Delete();
+                foreach (var file in toDelete)
+                {
+                    Logger.Default.Debug($"Deleting old log file {file}");
+                    file.Delete();
+                }
             }
             catch (Exception e)
             {
-                Logger.Default.Error("Error compressing old log file:");
+                Logger.Default.Error("Error deleting old log files:");
                 Logger.Default.Error(e);
             }
         }
@@ -115,24 +179,164 @@ namespace IPA.Logging.Printers
         /// Called at the start of any print session.
         /// </summary>
         public sealed override void StartPrint()
+        {
+            if (FileWriter is null)
+                OpenStreams();
+        }
+
+        [MemberNotNull(nameof(FileWriter))]
+        private void OpenStreams()
         {
             InitLog();
 
-            fstream = fileInfo.Open(FileMode.Append, FileAccess.Write);
-            FileWriter = new StreamWriter(fstream, new UTF8Encoding(false));
+            fstream = fileInfo.Open(FileMode.Append, FileAccess.Write, FileShare.Read);
+            gzstream = new GZipStream(fstream, CompressionMode.Compress, CompressionLevel.BestSpeed, false);
+            FileWriter = new StreamWriter(gzstream, new UTF8Encoding(false), writerBufferSize);
+            lastFlush = lastPrint = Utils.CurrentTime();
+            hasUnflushedData = false;
+
+            lock (openPrintersLock)
+                openPrinters.Add(this);
+        }
+
+        /// <summary>
+        /// Prints a batch of messages, then sync-flushes the compressor if <see cref="FlushInterval"/> has passed since the last flush.
+        /// </summary>
+        /// <remarks>
+        /// If the file has grown past <see cref="MaxFileSize"/>, it is finished and a new one is started before printing.
+        /// </remarks>
+        /// <param name="messages">the messages to print</param>
+        public override void Print(ArraySegment<LogMessage> messages)
+        {
+            if (fstream is not null && fstream.Length >= MaxFileSize)
+            { // finishing the member flushes everything, so the length is accurate when InitLog checks it
+                CloseStreams();
+                OpenStreams();
+            }
+            else if (FileWriter is null)
+                OpenStreams();
+
+            base.Print(messages);
+            hasUnflushedData = true;
+
+            var now = Utils.CurrentTime();
+            lastPrint = now;
+            if (now - lastFlush >= FlushInterval)
+            {
+                SyncFlush();
+                lastFlush = now;
+            }
+        }
+
+        private void SyncFlush()
+        {
+            if (FileWriter is null || gzstream is null || fstream is null || !hasUnflushedData)
+                return;
+
+            FileWriter.Flush(); // push all buffered text into the compressor
+
+            gzstream.FlushMode = FlushType.Sync;
+            try
+            { // an empty write with a sync flush emits everything the compressor is holding on to, aligned to a byte boundary
+                gzstream.Write(Array.Empty<byte>(), 0, 0);
+            }
+            catch (ZlibException)
+            { // there was nothing to flush
+            }
+            finally
+            {
+                gzstream.FlushMode = FlushType.None;
+            }
+
+            fstream.Flush();
+            hasUnflushedData = false;
         }
 
         /// <summary>
         /// Called at the end of any print session.
         /// </summary>
+        /// <remarks>
+        /// This only sync-flushes the compressor. The file stays open until <see cref="CloseIdle"/> finds it unused, so a session
+        /// that follows soon after continues the same GZip member.
+        /// </remarks>
         public sealed override void EndPrint()
+            => SyncFlush();
+
+        private void CloseStreams()
         {
-            FileWriter?.Flush();
-            fstream?.Flush();
+            if (FileWriter is null && fstream is null)
+                return;
+
+            // disposing the writer finishes the GZip member, and closes the underlying streams
             FileWriter?.Dispose();
+            gzstream?.Dispose();
             fstream?.Dispose();
             FileWriter = null;
+            gzstream = null;
             fstream = null;
+
+            lock (openPrintersLock)
+                _ = openPrinters.Remove(this);
+        }
+
+        /// <summary>
+        /// Finishes the files of printers that haven't printed anything for their <see cref="FlushInterval"/>. Called by the
+        /// log thread while it waits for messages.
+        /// </summary>
+        /// <returns>the time until the next open printer becomes idle, or <see cref="Timeout.InfiniteTimeSpan"/> if none are open</returns>
+        internal static TimeSpan CloseIdle()
+        {
+            List<GZFilePrinter> idle;
+            var next = Timeout.InfiniteTimeSpan;
+            var now = Utils.CurrentTime();
+            lock (openPrintersLock)
+            {
+                idle = new List<GZFilePrinter>();
+                foreach (var printer in openPrinters)
+                {
+                    var remaining = printer.lastPrint + printer.FlushInterval - now;
+                    if (remaining <= TimeSpan.Zero)
+                        idle.Add(printer);
+                    else if (next == Timeout.InfiniteTimeSpan || remaining < next)
+                        next = remaining;
+                }
+            }
+
+            foreach (var printer in idle)
+            {
+                try
+                {
+                    printer.CloseStreams();
+                }
+                catch (Exception e)
+                {
+                    Console.WriteLine($"printer errored: {e}");
+                }
+            }
+
+            return next;
+        }
+
+        /// <summary>
+        /// Finishes the files of all printers that are still open. Called by the log thread when it shuts down.
+        /// </summary>
+        internal static void CloseAll()
+        {
+            GZFilePrinter[] printers;
+            lock (openPrintersLock)
+                printers = openPrinters.ToArray();
+
+            foreach (var printer in printers)
+            {
+                try
+                {
+                    printer.CloseStreams();
+                }
+                catch (Exception e)
+                {
+                    Console.WriteLine($"printer errored: {e}");
+                }
+            }
         }
 
         /// <inheritdoc />
@@ -149,14 +353,7 @@ namespace IPA.Logging.Printers
         protected virtual void Dispose(bool disposing)
         {
             if (disposing)
-            {
-                FileWriter?.Flush();
-                fstream?.Flush();
-                FileWriter?.Close();
-                fstream?.Close();
-                FileWriter?.Dispose();
-                fstream?.Dispose();
-            }
+                CloseStreams();
         }
     }
-}
\ No newline at end of file
+}
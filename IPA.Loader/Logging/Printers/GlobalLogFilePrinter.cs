@@ -9,11 +9,21 @@ namespace IPA.Logging.Printers
     /// </summary>
     public class GlobalLogFilePrinter : GZFilePrinter
     {
+        private Logger.LogLevel filter = Logger.LogLevel.All;
+
         /// <summary>
         /// Provides a filter for this specific printer.
         /// </summary>
         /// <value>the filter level for this printer</value>
-        public override Logger.LogLevel Filter { get; set; } = Logger.LogLevel.All;
+        public override Logger.LogLevel Filter
+        {
+            get => filter;
+            set
+            {
+                filter = value;
+                StandardLogger.PrintersChanged(); // loggers cache which levels their printers accept
+            }
+        }
 
         /// <summary>
         /// Prints an entry to the associated file.
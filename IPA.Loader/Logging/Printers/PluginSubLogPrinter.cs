@@ -9,11 +9,21 @@ namespace IPA.Logging.Printers
     /// </summary>
     public class PluginSubLogPrinter : GZFilePrinter
     {
+        private Logger.LogLevel filter = Logger.LogLevel.All;
+
         /// <summary>
         /// Provides a filter for this specific printer.
         /// </summary>
         /// <value>the filter for this printer</value>
-        public override Logger.LogLevel Filter { get; set; } = Logger.LogLevel.All;
+        public override Logger.LogLevel Filter
+        {
+            get => filter;
+            set
+            {
+                filter = value;
+                StandardLogger.PrintersChanged(); // loggers cache which levels their printers accept
+            }
+        }
 
         private string name;
         private string mainName;
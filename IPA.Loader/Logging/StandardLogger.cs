@@ -3,8 +3,8 @@
 using IPA.Config;
 using IPA.Logging.Printers;
 using IPA.Utilities;
+using IPA.Utilities.Async;
 using System;
-using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Diagnostics;
 using System.IO;
@@ -19,6 +19,8 @@ namespace IPA.Logging
     /// <remarks>
     /// <see cref="StandardLogger"/> uses a multi-threaded approach to logging. All actual I/O is done on another thread,
     /// where all messaged are guaranteed to be logged in the order they appeared. It is up to the printers to format them.
+    /// Messages are passed to that thread through a bounded queue, and when it is full, logging calls will wait for space
+    /// rather than dropping messages.
     ///
     /// This logger supports child loggers. Use <see cref="LoggerExtensions.GetChildLogger"/> to safely get a child.
     /// The modification of printers on a parent are reflected down the chain.
@@ -26,6 +28,9 @@ namespace IPA.Logging
     public class StandardLogger : Logger
     {
         private static readonly List<LogPrinter> defaultPrinters = new();
+        private static readonly object printersLock = new();
+        // incremented whenever any logger's printers change, to invalidate the flattened printer arrays
+        private static int printersVersion;
 
         static StandardLogger()
         {
@@ -38,7 +43,7 @@ namespace IPA.Logging
         {
             if (!addedConsolePrinters && !finalizedDefaultPrinters && WinConsole.IsInitialized )
             {
-                defaultPrinters.AddRange(new []
+                AddDefaultPrinters(new []
                 {
                     new ColoredConsolePrinter()
                     {
@@ -76,7 +81,6 @@ namespace IPA.Logging
                         Color = ConsoleColor.Magenta,
                     }
                 });
-
                 addedConsolePrinters = true;
             }
         }
@@ -92,8 +96,24 @@ namespace IPA.Logging
         /// </summary>
         /// <param name="printer">the printer to add</param>
         internal static void AddDefaultPrinter(LogPrinter printer)
+            => AddDefaultPrinters(new[] { printer });
+
+        private static void AddDefaultPrinters(IEnumerable<LogPrinter> printers)
         {
-            defaultPrinters.Add(printer);
+            lock (printersLock)
+            {
+                defaultPrinters.AddRange(printers);
+                printersVersion++;
+            }
+        }
+
+        /// <summary>
+        /// Invalidates everything cached about the printers, like the levels each logger accepts.
+        /// </summary>
+        internal static void PrintersChanged()
+        {
+            lock (printersLock)
+                printersVersion++;
         }
 
         private readonly string logName;
@@ -110,6 +130,12 @@ namespace IPA.Logging
         private readonly List<LogPrinter> printers = new();
         private readonly StandardLogger? parent;
 
+        // these are only accessed on the log thread
+        private LogPrinter[]? flattenedPrinters;
+        private int flattenedVersion;
+        private static LogPrinter[]? flattenedDefaultPrinters;
+        private static int flattenedDefaultVersion;
+
         private readonly Dictionary<string, StandardLogger> children = new();
 
         private static bool addedFilePrinter = false;
@@ -119,7 +145,11 @@ namespace IPA.Logging
         internal static void Configure()
         {
             showSourceClass = SelfConfig.Debug_.ShowCallSource_;
-            PrintFilter = SelfConfig.Debug_.ShowDebug_ ? LogLevel.All : LogLevel.InfoUp;
+            lock (printersLock)
+            {
+                PrintFilter = SelfConfig.Debug_.ShowDebug_ ? LogLevel.All : LogLevel.InfoUp;
+                printersVersion++; // the console printers' accepted levels depend on this
+            }
             showTrace = SelfConfig.Debug_.ShowTrace_;
             syncLogging = SelfConfig.Debug_.SyncLogging_;
             if (SelfConfig.CommandLineValues.WriteLogs && !addedFilePrinter)
@@ -137,11 +167,7 @@ namespace IPA.Logging
             if (SelfConfig.Debug_.CreateModLogs_ && !SelfConfig.Debug_.CondenseModLogs_)
                 printers.Add(new PluginSubLogPrinter(parent.logName, subName));
 
-            if (logThread == null || !logThread.IsAlive)
-            {
-                logThread = new Thread(LogThread);
-                logThread.Start();
-            }
+            EnsureLogThread();
         }
 
         internal StandardLogger(string name)
@@ -159,11 +185,7 @@ namespace IPA.Logging
             if (SelfConfig.Debug_.CreateModLogs_)
                 printers.Add(new PluginLogFilePrinter(name));
 
-            if (logThread == null || !logThread.IsAlive)
-            {
-                logThread = new Thread(LogThread);
-                logThread.Start();
-            }
+            EnsureLogThread();
         }
 
         /// <summary>
@@ -188,7 +210,135 @@ namespace IPA.Logging
         /// <param name="printer">the printer to add</param>
         public void AddPrinter(LogPrinter printer)
         {
-            printers.Add(printer);
+            lock (printersLock)
+            {
+                printers.Add(printer);
+                printersVersion++;
+            }
+        }
+
+        private void ClearPrinters()
+        {
+            lock (printersLock)
+            {
+                printers.Clear();
+                printersVersion++;
+            }
+        }
+
+        /// <summary>
+        /// Gets every printer that a message from this logger should go to, in order: this logger's own, its parents', then the defaults.
+        /// </summary>
+        /// <remarks>
+        /// This is only ever called on the log thread, and is recomputed only when some printer set changes. Loggers which don't
+        /// have any printers of their own share their parent's array, so that runs of messages can be batched across them.
+        /// </remarks>
+        private LogPrinter[] FlattenedPrinters
+        {
+            get
+            {
+                var version = Volatile.Read(ref printersVersion);
+                if (flattenedPrinters is not null && flattenedVersion == version)
+                    return flattenedPrinters;
+
+                lock (printersLock)
+                {
+                    version = printersVersion;
+                    var inherited = parent?.FlattenedPrinters ?? DefaultPrinters;
+                    flattenedPrinters = printers.Count == 0 ? inherited : printers.Concat(inherited).ToArray();
+                    flattenedVersion = version;
+                    return flattenedPrinters;
+                }
+            }
+        }
+
+        private sealed class AcceptedLevelsCache
+        {
+            public readonly int Version;
+            public readonly LogLevel Levels;
+            // printers from other assemblies, which don't tell us when their filter changes, so they are asked every time
+            public readonly LogPrinter[] Unmanaged;
+
+            public AcceptedLevelsCache(int version, LogLevel levels, LogPrinter[] unmanaged)
+            {
+                Version = version;
+                Levels = levels;
+                Unmanaged = unmanaged;
+            }
+        }
+
+        private volatile AcceptedLevelsCache? acceptedLevels;
+
+        /// <summary>
+        /// Gets the union of the levels accepted by all printers that this logger prints to. Unlike <see cref="FlattenedPrinters"/>,
+        /// this is safe to use from any thread.
+        /// </summary>
+        /// <remarks>
+        /// The printers in this assembly call <see cref="PrintersChanged"/> when their filter is set, so their levels can be
+        /// cached. Other printers are asked on every call. If there are no printers at all yet, every level is accepted, so that
+        /// messages logged that early are still queued for the printers that are added later.
+        /// </remarks>
+        private LogLevel AcceptedLevels
+        {
+            get
+            {
+                var cache = acceptedLevels;
+                if (cache is null || cache.Version != Volatile.Read(ref printersVersion))
+                    acceptedLevels = cache = ComputeAcceptedLevels();
+
+                var levels = cache.Levels;
+                foreach (var printer in cache.Unmanaged)
+                    levels |= printer.AcceptedLevels;
+                return levels;
+            }
+        }
+
+        private AcceptedLevelsCache ComputeAcceptedLevels()
+        {
+            lock (printersLock)
+            {
+                var levels = LogLevel.None;
+                var unmanaged = new List<LogPrinter>();
+                var any = false;
+
+                void Add(LogPrinter printer)
+                {
+                    any = true;
+                    if (printer.GetType().Assembly == typeof(LogPrinter).Assembly)
+                        levels |= printer.AcceptedLevels;
+                    else
+                        unmanaged.Add(printer);
+                }
+
+                for (var logger = this; logger is not null; logger = logger.parent)
+                {
+                    foreach (var printer in logger.printers)
+                        Add(printer);
+                }
+                foreach (var printer in defaultPrinters)
+                    Add(printer);
+
+                if (!any)
+                    levels = LogLevel.All;
+
+                return new(printersVersion, levels, unmanaged.ToArray());
+            }
+        }
+
+        private static LogPrinter[] DefaultPrinters
+        {
+            get
+            {
+                var version = Volatile.Read(ref printersVersion);
+                if (flattenedDefaultPrinters is not null && flattenedDefaultVersion == version)
+                    return flattenedDefaultPrinters;
+
+                lock (printersLock)
+                {
+                    flattenedDefaultVersion = printersVersion;
+                    return flattenedDefaultPrinters = defaultPrinters.ToArray();
+                }
+            }
         }
 
         /// <summary>
@@ -201,35 +351,80 @@ namespace IPA.Logging
             if (message == null)
                 throw new ArgumentNullException(nameof(message));
 
+            if (!IsEnabled(level)) return;
+
+            Enqueue(level, message);
+        }
+
+        /// <summary>
+        /// Checks whether or not a message at <paramref name="level"/> would be accepted by any printer this logger prints to.
+        /// </summary>
+        /// <param name="level">the level to check</param>
+        /// <returns><see langword="true"/> if a message at <paramref name="level"/> would be printed, <see langword="false"/> otherwise</returns>
+        public override bool IsEnabled(Level level)
+        {
             // FIXME: trace doesn't seem to ever actually appear
-            if (!showTrace && level == Level.Trace) return;
+            if (!showTrace && level == Level.Trace) return false;
+            return ((byte)level & (byte)AcceptedLevels) != 0;
+        }
 
-            // make sure that the queue isn't being cleared
-            logWaitEvent.Wait();
-            try
-            {
-                var sync = syncLogging && !IsOnLoggerThread;
-                if (sync)
-                {
-                    threadSync ??= new ManualResetEventSlim();
-                    threadSync.Reset();
-                }
+        /// <inheritdoc />
+        /// <remarks>
+        /// If the message is accepted, formatting it is deferred to the log thread.
+        /// </remarks>
+        public override void Log<T1>(Level level, string format, T1 arg1)
+        {
+            if (format == null)
+                throw new ArgumentNullException(nameof(format));
+            if (IsEnabled(level))
+                Enqueue(level, new DeferredMessage<T1>(format, arg1));
+        }
 
-                logQueue.Add(new LogMessage
-                {
-                    Level = level,
-                    Message = message,
-                    Logger = this,
-                    Time = Utils.CurrentTime(),
-                    Sync = threadSync
-                });
+        /// <inheritdoc />
+        /// <remarks>
+        /// If the message is accepted, formatting it is deferred to the log thread.
+        /// </remarks>
+        public override void Log<T1, T2>(Level level, string format, T1 arg1, T2 arg2)
+        {
+            if (format == null)
+                throw new ArgumentNullException(nameof(format));
+            if (IsEnabled(level))
+                Enqueue(level, new DeferredMessage<T1, T2>(format, arg1, arg2));
+        }
 
-                if (sync) threadSync!.Wait();
-            }
-            catch (InvalidOperationException)
+        /// <inheritdoc />
+        /// <remarks>
+        /// If the message is accepted, formatting it is deferred to the log thread.
+        /// </remarks>
+        public override void Log<T1, T2, T3>(Level level, string format, T1 arg1, T2 arg2, T3 arg3)
+        {
+            if (format == null)
+                throw new ArgumentNullException(nameof(format));
+            if (IsEnabled(level))
+                Enqueue(level, new DeferredMessage<T1, T2, T3>(format, arg1, arg2, arg3));
+        }
+
+        private void Enqueue(Level level, object content)
+        {
+            var sync = syncLogging && !IsOnLoggerThread;
+            if (sync)
             {
-                // the queue has been closed, so we leave it
+                threadSync ??= new ManualResetEventSlim();
+                threadSync.Reset();
             }
+
+            var msg = new LogMessage(level, Utils.CurrentTime(), this, logName, content, sync ? threadSync : null);
+
+            if (IsOnLoggerThread)
+            { // the log thread is the only consumer, so it must never wait on the queue
+                if ((loggerThreadOverflow.Count > 0 || !logQueue.TryEnqueue(msg)) && !logQueue.IsAddingCompleted)
+                    loggerThreadOverflow.Enqueue(msg);
+                return;
+            }
+
+            // this waits if the queue is full, and only fails when the queue has been closed
+            if (logQueue.Enqueue(msg) && sync)
+                threadSync!.Wait();
         }
 
         [ThreadStatic]
@@ -263,15 +458,6 @@ namespace IPA.Logging
             base.Debug(message);
         }
 
-        private struct LogMessage
-        {
-            public Level Level;
-            public StandardLogger Logger;
-            public string Message;
-            public DateTime Time;
-            public ManualResetEventSlim? Sync;
-        }
-
         [ThreadStatic]
         private static bool? isOnLoggerThread = null;
         /// <summary>
@@ -280,14 +466,27 @@ namespace IPA.Logging
         /// <value><see langword="true"/> if the current thread is the logger thread, <see langword="false"/> otherwise</value>
         public static bool IsOnLoggerThread => isOnLoggerThread ??= Thread.CurrentThread.ManagedThreadId == logThread?.ManagedThreadId;
 
-        private static readonly ManualResetEventSlim logWaitEvent = new(true);
-        private static readonly BlockingCollection<LogMessage> logQueue = new();
+        private const int LogQueueCapacity = 4096;
+        private const int LogBatchSize = 256;
+
+        private static readonly BoundedMpscQueue<LogMessage> logQueue = new(LogQueueCapacity);
+        // only accessed on the log thread, for messages it logs itself while the queue is full
+        private static readonly Queue<LogMessage> loggerThreadOverflow = new();
         private static Thread? logThread;
 
         private static StandardLogger? loggerLogger;
 
         private const int LogCloseTimeout = 250;
 
+        private static void EnsureLogThread()
+        {
+            if (logThread == null || !logThread.IsAlive)
+            {
+                logThread = new Thread(LogThread);
+                logThread.Start();
+            }
+        }
+
         /// <summary>
         /// The log printer thread for <see cref="StandardLogger"/>.
         /// </summary>
@@ -299,136 +498,164 @@ namespace IPA.Logging
             };
 
             loggerLogger = new StandardLogger("Log Subsystem");
-            loggerLogger.printers.Clear(); // don't need a log file for this one
+            loggerLogger.ClearPrinters(); // don't need a log file for this one
 
             var timeout = TimeSpan.FromMilliseconds(LogCloseTimeout);
+            var batch = new LogMessage[LogBatchSize];
+            var started = new List<LogPrinter>();
 
-            try
+            while (WaitForMessages())
             {
-                var started = new HashSet<LogPrinter>();
-                while (logQueue.TryTake(out var msg, Timeout.Infinite))
+                StdoutInterceptor.Intercept(); // only runs once, after the first message is queued
+                do
                 {
-                    StdoutInterceptor.Intercept(); // only runs once, after the first message is queued
-                    do
+                    int count;
+                    while ((count = logQueue.DequeueBatch(batch)) > 0)
                     {
-                        var logger = msg.Logger;
-                        IEnumerable<LogPrinter> printers = logger.printers;
-                        do
-                        { // aggregate all printers in the inheritance chain
-                            logger = logger.parent;
-                            if (logger != null)
-                                printers = printers.Concat(logger.printers);
-                        } while (logger != null);
-
-                        foreach (var printer in printers.Concat(defaultPrinters))
+                        PrintBatch(batch, count, started);
+
+                        while (loggerThreadOverflow.Count > 0)
                         {
-                            try
-                            { // print to them all
-                                if (((byte)msg.Level & (byte)printer.Filter) != 0)
-                                {
-                                    if (!started.Contains(printer))
-                                    { // start printer if not started
-                                        printer.StartPrint();
-                                        _ = started.Add(printer);
-                                    }
-
-                                    // update last use time and print
-                                    printer.LastUse = Utils.CurrentTime();
-                                    printer.Print(msg.Level, msg.Time, msg.Logger.logName, msg.Message);
-                                }
-                            }
-                            catch (Exception e)
-                            {
-                                // do something sane in the face of an error
-                                Console.WriteLine($"printer errored: {e}");
-                            }
+                            count = 0;
+                            while (count < batch.Length && loggerThreadOverflow.Count > 0)
+                                batch[count++] = loggerThreadOverflow.Dequeue();
+                            PrintBatch(batch, count, started);
                         }
 
-                        msg.Sync?.Set();
-
-                        var debugConfig = SelfConfig.Instance?.Debug;
-
-                        if (debugConfig != null && debugConfig.HideMessagesForPerformance
-                            && logQueue.Count > debugConfig.HideLogThreshold)
-                        { // spam filtering (if queue has more than HideLogThreshold elements)
-                            logWaitEvent.Reset(); // pause incoming log requests
-
-                            // clear loggers for this instance, to print the message to all affected logs
-                            loggerLogger.printers.Clear();
-                            var prints = new HashSet<LogPrinter>();
-                            // clear the queue
-                            while (logQueue.TryTake(out var message))
-                            { // aggregate loggers in the process
-                                var messageLogger = message.Logger;
-                                foreach (var print in messageLogger.printers)
-                                    _ = prints.Add(print);
-                                do
-                                {
-                                    messageLogger = messageLogger.parent;
-                                    if (messageLogger != null)
-                                        foreach (var print in messageLogger.printers)
-                                            _ = prints.Add(print);
-                                } while (messageLogger != null);
-
-                                message.Sync?.Set();
-                            }
-
-                            // print using logging subsystem to all logger printers
-                            loggerLogger.printers.AddRange(prints);
-                            logQueue.Add(new LogMessage
-                            { // manually adding to the queue instead of using Warn() because calls to the logger are suspended here
-                                Level = Level.Warning,
-                                Logger = loggerLogger,
-                                Message = $"{loggerLogger.logName.ToUpper()}: Messages omitted to improve performance",
-                                Time = Utils.CurrentTime()
-                            });
-
-                            // resume log calls
-                            logWaitEvent.Set();
-                        }
+                        // close printers 250ms after their last use
+                        EndPrinters(started, Utils.CurrentTime() - timeout);
+                    }
+                }
+                // wait for messages for 250ms before ending the prints
+                while (logQueue.WaitForItems(LogCloseTimeout));
 
-                        var now = Utils.CurrentTime();
-                        var copy = new List<LogPrinter>(started);
-                        foreach (var printer in copy)
-                        {
-                            // close printer after 500ms from its last use
-                            if (now - printer.LastUse > timeout)
-                            {
-                                try
-                                {
-                                    printer.EndPrint();
-                                }
-                                catch (Exception e)
-                                {
-                                    Console.WriteLine($"printer errored: {e}");
-                                }
-
-                                _ = started.Remove(printer);
-                            }
-                        }
+                // when the queue has been empty for 250ms, end all prints
+                EndPrinters(started, DateTime.MaxValue);
+            }
+
+            // the queue is closed, so finish the compressed logs
+            GZFilePrinter.CloseAll();
+        }
+
+        /// <summary>
+        /// Waits for the next messages, closing compressed logs that go unused in the meantime.
+        /// </summary>
+        /// <returns><see langword="true"/> if there are messages to print, <see langword="false"/> if the queue has been closed</returns>
+        private static bool WaitForMessages()
+        {
+            while (true)
+            {
+                var untilIdle = GZFilePrinter.CloseIdle();
+                var wait = untilIdle == Timeout.InfiniteTimeSpan
+                    ? Timeout.Infinite
+                    : (int)Math.Ceiling(untilIdle.TotalMilliseconds);
+                if (logQueue.WaitForItems(wait))
+                    return true;
+                if (logQueue.IsAddingCompleted)
+                    return false;
+            }
+        }
+
+        /// <summary>
+        /// Prints a batch of messages, grouping consecutive messages from the same logger with the same level into a single
+        /// <see cref="LogPrinter.Print(ArraySegment{LogMessage})"/> call. This keeps the order of messages the same for any
+        /// given printer, and for printers sharing an output, like the console.
+        /// </summary>
+        /// <remarks>
+        /// Child loggers without printers of their own share their parent's printer array, so grouping by printers alone
+        /// would mix messages from different logs in one call.
+        /// </remarks>
+        private static void PrintBatch(LogMessage[] batch, int count, List<LogPrinter> started)
+        {
+            var runStart = 0;
+            var runPrinters = batch[0].Source.FlattenedPrinters;
+            for (var i = 1; i <= count; i++)
+            {
+                LogPrinter[]? printers = null;
+                if (i < count)
+                {
+                    printers = batch[i].Source.FlattenedPrinters;
+                    if (printers == runPrinters && batch[i].Source == batch[runStart].Source
+                        && batch[i].Level == batch[runStart].Level)
+                        continue;
+                }
+
+                PrintRun(runPrinters, new ArraySegment<LogMessage>(batch, runStart, i - runStart), started);
+                runStart = i;
+                runPrinters = printers!;
+            }
+
+            for (var i = 0; i < count; i++)
+            {
+                batch[i].Sync?.Set();
+                batch[i] = default;
+            }
+        }
+
+        private static void PrintRun(LogPrinter[] printers, ArraySegment<LogMessage> run, List<LogPrinter> started)
+        {
+            var level = run.Array[run.Offset].Level;
+            var now = Utils.CurrentTime();
+            var rendered = false;
+            foreach (var printer in printers)
+            {
+                try
+                { // print to them all
+                    if (((byte)level & (byte)printer.Filter) == 0)
+                        continue;
+
+                    if (!rendered)
+                    { // only format templated messages once something will actually print them
+                        RenderRun(run);
+                        rendered = true;
                     }
-                    // wait for messages for 500ms before ending the prints
-                    while (logQueue.TryTake(out msg, timeout));
 
-                    if (logQueue.Count == 0)
-                    { // when the queue has been empty for 500ms, end all prints
-                        foreach (var printer in started)
-                        {
-                            try
-                            {
-                                printer.EndPrint();
-                            }
-                            catch (Exception e)
-                            {
-                                Console.WriteLine($"printer errored: {e}");
-                            }
-                        }
-                        started.Clear();
+                    if (!printer.Started)
+                    { // start printer if not started
+                        printer.StartPrint();
+                        printer.Started = true;
+                        started.Add(printer);
                     }
+
+                    // update last use time and print
+                    printer.LastUse = now;
+                    printer.Print(run);
+                }
+                catch (Exception e)
+                {
+                    // do something sane in the face of an error
+                    Console.WriteLine($"printer errored: {e}");
                 }
             }
-            catch (InvalidOperationException)
+        }
+
+        private static void RenderRun(ArraySegment<LogMessage> run)
+        {
+            var arr = run.Array;
+            var end = run.Offset + run.Count;
+            for (var i = run.Offset; i < end; i++)
+                arr[i] = arr[i].Rendered();
+        }
+
+        private static void EndPrinters(List<LogPrinter> started, DateTime lastUsedBefore)
+        {
+            for (var i = started.Count - 1; i >= 0; i--)
             {
+                var printer = started[i];
+                if (printer.LastUse >= lastUsedBefore)
+                    continue;
+
+                try
+                {
+                    printer.EndPrint();
+                }
+                catch (Exception e)
+                {
+                    Console.WriteLine($"printer errored: {e}");
+                }
+
+                printer.Started = false;
+                started.RemoveAt(i);
             }
         }
 
@@ -437,8 +664,9 @@ namespace IPA.Logging
         /// </summary>
         internal static void StopLogThread()
         {
+            StdoutInterceptor.FlushAll(); // partial lines would be lost otherwise
             logQueue.CompleteAdding();
-            logThread!.Join();
+            logThread?.Join();
         }
     }
 
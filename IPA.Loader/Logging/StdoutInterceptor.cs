@@ -16,41 +16,231 @@ namespace IPA.Logging
 
         private bool isStdErr;
 
+        private readonly Action<string>? sink;
+
+        public StdoutInterceptor() { }
+
+        /// <summary>
+        /// Creates an interceptor that hands completed lines to <paramref name="sink"/> instead of the stdout logger.
+        /// </summary>
+        /// <param name="sink">the receiver of every emitted message</param>
+        internal StdoutInterceptor(Action<string> sink)
+            => this.sink = sink;
+
+        /// <summary>
+        /// A growable buffer holding the part of a line that has been written, but not yet terminated.
+        /// </summary>
+        /// <remarks>
+        /// Only its own thread writes to it, but it is locked anyway, because <see cref="FlushAll"/>, and any thread that
+        /// outlives its owner, may empty it.
+        /// </remarks>
+        private sealed class LineBuffer
+        {
+            private const int InitialSize = 256;
+            private const int MaxRetainedSize = 16 * 1024;
+
+            private char[] chars = new char[InitialSize];
+            private int length;
+
+            public readonly Thread Owner = Thread.CurrentThread;
+
+            public bool IsEmpty => length == 0;
+
+            public void Append(char value)
+            {
+                if (length == chars.Length)
+                    Array.Resize(ref chars, chars.Length * 2);
+                chars[length++] = value;
+            }
+
+            public void Append(string value, int start, int count)
+            {
+                if (length + count > chars.Length)
+                    Array.Resize(ref chars, Math.Max(chars.Length * 2, length + count));
+                value.CopyTo(start, chars, length, count);
+                length += count;
+            }
+
+            public void MoveTo(StringBuilder builder)
+            {
+                _ = builder.Append(chars, 0, length);
+                length = 0;
+                if (chars.Length > MaxRetainedSize) // don't hold on to a huge buffer because of one long line
+                    chars = new char[InitialSize];
+            }
+        }
+
+        // lines are staged per thread, so writes from different threads neither contend nor mix into the same line
+        [ThreadStatic]
+        private static LineBuffer? stdoutLineBuffer;
+        [ThreadStatic]
+        private static LineBuffer? stderrLineBuffer;
+
+        // every thread's buffer for this stream, so that partial lines can be flushed from anywhere
+        private readonly List<LineBuffer> lineBuffers = new();
+
+        private LineBuffer CurrentLineBuffer
+        {
+            get
+            {
+                var buffer = isStdErr ? stderrLineBuffer : stdoutLineBuffer;
+                if (buffer != null)
+                    return buffer;
+
+                buffer = new LineBuffer();
+                if (isStdErr)
+                    stderrLineBuffer = buffer;
+                else
+                    stdoutLineBuffer = buffer;
+
+                // a new thread is a good time to pick up the lines that threads which have exited left behind
+                FlushPartialLines(FlushScope.Abandoned);
+                lock (lineBuffers)
+                    lineBuffers.Add(buffer);
+                return buffer;
+            }
+        }
+
+        private static readonly char[] newlineChars = { '\r', '\n' };
+
         public override void Write(char value)
         {
-            Write(value.ToString());
+            var buffer = CurrentLineBuffer;
+            lock (buffer)
+            {
+                if (value is not '\r' and not '\n')
+                {
+                    buffer.Append(value);
+                    return;
+                }
+
+                if (buffer.IsEmpty) return;
+
+                var lines = new StringBuilder();
+                AppendLine(lines, buffer, "", 0, 0);
+                Emit(lines);
+            }
         }
 
-        private string lineBuffer = "";
-        private readonly object bufferLock = new();
+        public override void Write(char[] buffer, int index, int count)
+            => Write(new string(buffer, index, count));
 
-        public override void Write(string value)
+        public override void Write(string? value)
         {
-            lock (bufferLock)
-            { // avoid threading issues
-                lineBuffer += value;
+            if (string.IsNullOrEmpty(value)) return;
 
-                var parts = lineBuffer.Split(new[] { Environment.NewLine, "\n", "\r" }, StringSplitOptions.None);
-                for (int i = 0; i < parts.Length; i++)
+            var buffer = CurrentLineBuffer;
+            lock (buffer)
+            {
+                StringBuilder? lines = null;
+
+                var start = 0;
+                while (start < value!.Length)
                 {
-                    if (i + 1 == parts.Length) // last element
-                        lineBuffer = parts[i];
-                    else
-                    {
-                        var str = parts[i];
-                        if (string.IsNullOrEmpty(str)) continue;
-                        if (!isStdErr && WinConsole.IsInitialized)
-                            str = ConsoleColorToForegroundSet(currentColor) + str;
-
-                        if (isStdErr)
-                            Logger.stdout.Error(str);
-                        else
-                            Logger.stdout.Info(str);
+                    var end = value.IndexOfAny(newlineChars, start);
+                    if (end < 0)
+                    { // no line end, so keep the rest for later
+                        buffer.Append(value, start, value.Length - start);
+                        break;
                     }
+
+                    // any sequence of line separators ends a line, and empty lines are skipped
+                    if (end > start || !buffer.IsEmpty)
+                        AppendLine(lines ??= new StringBuilder(), buffer, value, start, end - start);
+
+                    start = end + 1;
                 }
+
+                // all lines completed by one write are logged as one message, which the printers split back into lines
+                if (lines != null)
+                    Emit(lines);
             }
         }
 
+        /// <summary>
+        /// Logs the unterminated line of the calling thread, and those left behind by threads that have exited, as they are.
+        /// </summary>
+        /// <remarks>
+        /// Other live threads keep their partial lines, so that a flush from one thread can't cut a line another is still writing.
+        /// </remarks>
+        public override void Flush()
+            => FlushPartialLines(FlushScope.CurrentThread);
+
+        private enum FlushScope
+        {
+            Abandoned,
+            CurrentThread,
+            All,
+        }
+
+        /// <summary>
+        /// Logs the unterminated lines in the buffers of this stream, and forgets the buffers of threads that have exited.
+        /// </summary>
+        /// <param name="scope">which live threads to flush the buffers of, in addition to those of threads that have exited</param>
+        private void FlushPartialLines(FlushScope scope)
+        {
+            var current = Thread.CurrentThread;
+
+            LineBuffer[] buffers;
+            lock (lineBuffers)
+            {
+                buffers = lineBuffers.ToArray();
+                _ = lineBuffers.RemoveAll(b => !b.Owner.IsAlive);
+            }
+
+            foreach (var buffer in buffers)
+            {
+                if (buffer.Owner.IsAlive && scope != FlushScope.All
+                    && (scope != FlushScope.CurrentThread || buffer.Owner != current))
+                    continue;
+
+                lock (buffer)
+                {
+                    if (buffer.IsEmpty) continue;
+
+                    var lines = new StringBuilder();
+                    AppendLine(lines, buffer, "", 0, 0);
+                    Emit(lines);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Logs every partial line that has been written to the intercepted streams, from any thread.
+        /// Called only before the log thread shuts down, when nothing else will flush them.
+        /// </summary>
+        internal static void FlushAll()
+        {
+            stdoutInterceptor?.FlushAllThreads();
+            stderrInterceptor?.FlushAllThreads();
+        }
+
+        /// <summary>
+        /// Logs every partial line written to this interceptor, from any thread.
+        /// </summary>
+        internal void FlushAllThreads()
+            => FlushPartialLines(FlushScope.All);
+
+        private void AppendLine(StringBuilder lines, LineBuffer buffer, string value, int start, int count)
+        {
+            if (lines.Length > 0)
+                _ = lines.Append('\n');
+            if (!isStdErr && WinConsole.IsInitialized)
+                _ = lines.Append(ConsoleColorToForegroundSet(currentColor));
+            buffer.MoveTo(lines);
+            _ = lines.Append(value, start, count);
+        }
+
+        private void Emit(StringBuilder lines)
+        {
+            if (sink != null)
+                sink(lines.ToString());
+            else if (isStdErr)
+                Logger.stdout.Error(lines.ToString());
+            else
+                Logger.stdout.Info(lines.ToString());
+        }
+
         private const ConsoleColor defaultColor = ConsoleColor.Gray;
         private ConsoleColor currentColor = defaultColor;
 
@@ -25,6 +25,7 @@ using System.Runtime.InteropServices;
 [assembly: Guid("5ad344f0-01a0-4ca8-92e5-9d095737744d")]
 [assembly: InternalsVisibleTo("IPA.Injector")]
 [assembly: InternalsVisibleTo("BSIPA-ModList")]
+[assembly: InternalsVisibleTo("IPA.Tests")]
 
 // Version information for an assembly consists of the following four values:
 //
@@ -13,6 +13,11 @@ namespace IPA.Utilities
     /// </summary>
     /// <typeparam name="T">the type that the fields are on</typeparam>
     /// <typeparam name="U">the type of the field to access</typeparam>
+    /// <remarks>
+    /// The by-name methods look the accessor up on every call. For fields that are accessed often, get a
+    /// <see cref="Handle"/> once with <see cref="GetHandle(string)"/>, keep it in a <see langword="static"/>
+    /// <see langword="readonly"/> field, and use that instead.
+    /// </remarks>
     /// <seealso cref="PropertyAccessor{T, U}"/>
     public static class FieldAccessor<T, U>
     {
@@ -46,8 +51,84 @@ namespace IPA.Utilities
             return (Accessor)dyn.CreateDelegate(typeof(Accessor));
         }
 
-        // field name -> accessor
-        private static readonly SingleCreationValueCache<string, Accessor> accessors = new SingleCreationValueCache<string, Accessor>();
+        /// <summary>
+        /// A resolved accessor for one field of <typeparamref name="T"/>.
+        /// </summary>
+        /// <remarks>
+        /// Using a handle skips the lookup by name that the static methods of <see cref="FieldAccessor{T, U}"/> do on
+        /// every call.
+        /// </remarks>
+        public sealed class Handle
+        {
+            private readonly Accessor accessor;
+
+            /// <summary>
+            /// Gets the name of the field this handle accesses.
+            /// </summary>
+            /// <value>the name of the field</value>
+            public string Name { get; }
+
+            /// <summary>
+            /// Gets the <see cref="FieldAccessor{T, U}.Accessor"/> delegate for the field.
+            /// </summary>
+            /// <value>the accessor delegate for the field</value>
+            public Accessor Accessor => accessor;
+
+            internal Handle(string name, Accessor accessor)
+            {
+                Name = name;
+                this.accessor = accessor;
+            }
+
+            /// <summary>
+            /// Accesses the field on an object.
+            /// </summary>
+            /// <param name="obj">the object to access the field of</param>
+            /// <returns>a reference to the object at the field</returns>
+            public ref U Access(ref T obj) => ref accessor(ref obj);
+            /// <summary>
+            /// Gets the value of the field on an object.
+            /// </summary>
+            /// <param name="obj">the object to access the field of</param>
+            /// <returns>the value of the field</returns>
+            public U Get(ref T obj) => accessor(ref obj);
+            /// <summary>
+            /// Gets the value of the field on an object.
+            /// </summary>
+            /// <param name="obj">the object to access the field of</param>
+            /// <returns>the value of the field</returns>
+            public U Get(T obj) => accessor(ref obj);
+            /// <summary>
+            /// Sets the value of the field on an object.
+            /// </summary>
+            /// <remarks>
+            /// This overload must be used for value types.
+            /// </remarks>
+            /// <param name="obj">the object to set the field of</param>
+            /// <param name="value">the value to set it to</param>
+            public void Set(ref T obj, U value) => accessor(ref obj) = value;
+            /// <summary>
+            /// Sets the value of the field on an object.
+            /// </summary>
+            /// <remarks>
+            /// This overload cannot be safely used for value types. Use <see cref="Set(ref T, U)"/> instead.
+            /// </remarks>
+            /// <param name="obj">the object to set the field of</param>
+            /// <param name="value">the value to set it to</param>
+            public void Set(T obj, U value) => accessor(ref obj) = value;
+        }
+
+        // field name -> handle
+        private static readonly CopyOnWriteValueCache<string, Handle> handles = new();
+
+        /// <summary>
+        /// Gets a <see cref="Handle"/> for the field named <paramref name="name"/> on <typeparamref name="T"/>.
+        /// </summary>
+        /// <param name="name">the field name</param>
+        /// <returns>a handle for the field</returns>
+        /// <exception cref="MissingFieldException">if the field does not exist on <typeparamref name="T"/></exception>
+        public static Handle GetHandle(string name)
+            => handles.GetOrAdd(name, n => new Handle(n, MakeAccessor(n)));
 
         /// <summary>
         /// Gets an <see cref="Accessor"/> for the field named <paramref name="name"/> on <typeparamref name="T"/>.
@@ -56,7 +137,7 @@ namespace IPA.Utilities
         /// <returns>an accessor for the field</returns>
         /// <exception cref="MissingFieldException">if the field does not exist on <typeparamref name="T"/></exception>
         public static Accessor GetAccessor(string name)
-            => accessors.GetOrAdd(name, MakeAccessor);
+            => GetHandle(name).Accessor;
 
         /// <summary>
         /// Accesses a field for an object by name.
@@ -128,6 +209,11 @@ namespace IPA.Utilities
     /// </summary>
     /// <typeparam name="T">the type that the properties are on</typeparam>
     /// <typeparam name="U">the type of the property to access</typeparam>
+    /// <remarks>
+    /// The by-name methods look the accessors up on every call. For properties that are accessed often, get a
+    /// <see cref="Handle"/> once with <see cref="GetHandle(string)"/>, keep it in a <see langword="static"/>
+    /// <see langword="readonly"/> field, and use that instead.
+    /// </remarks>
     public static class PropertyAccessor<T, U>
     {
         /// <summary>
@@ -193,11 +279,91 @@ namespace IPA.Utilities
             return (getter, setter);
         }
 
-        private static readonly SingleCreationValueCache<string, (Getter get, Setter set)> props
-            = new SingleCreationValueCache<string, (Getter get, Setter set)>();
+        /// <summary>
+        /// A resolved getter and setter for one property of <typeparamref name="T"/>.
+        /// </summary>
+        /// <remarks>
+        /// Using a handle skips the lookup by name that the static methods of <see cref="PropertyAccessor{T, U}"/> do
+        /// on every call.
+        /// </remarks>
+        public sealed class Handle
+        {
+            private readonly Getter getter;
+            private readonly Setter setter;
+
+            /// <summary>
+            /// Gets the name of the property this handle accesses.
+            /// </summary>
+            /// <value>the name of the property</value>
+            public string Name { get; }
+
+            /// <summary>
+            /// Gets the <see cref="PropertyAccessor{T, U}.Getter"/> for the property, if it has a getter.
+            /// </summary>
+            /// <value>the getter for the property, or <see langword="null"/> if it has none</value>
+            public Getter Getter => getter;
+            /// <summary>
+            /// Gets the <see cref="PropertyAccessor{T, U}.Setter"/> for the property, if it has a setter.
+            /// </summary>
+            /// <value>the setter for the property, or <see langword="null"/> if it has none</value>
+            public Setter Setter => setter;
+
+            internal Handle(string name, (Getter get, Setter set) accessors)
+            {
+                Name = name;
+                (getter, setter) = accessors;
+            }
+
+            /// <summary>
+            /// Gets the value of the property on <paramref name="obj"/>.
+            /// </summary>
+            /// <param name="obj">the instance to access</param>
+            /// <returns>the value of the property</returns>
+            /// <exception cref="InvalidOperationException">if the property has no getter</exception>
+            public U Get(ref T obj) => (getter ?? throw NoAccessor("getter"))(ref obj);
+            /// <summary>
+            /// Gets the value of the property on <paramref name="obj"/>.
+            /// </summary>
+            /// <param name="obj">the instance to access</param>
+            /// <returns>the value of the property</returns>
+            /// <exception cref="InvalidOperationException">if the property has no getter</exception>
+            public U Get(T obj) => (getter ?? throw NoAccessor("getter"))(ref obj);
+            /// <summary>
+            /// Sets the value of the property on <paramref name="obj"/>.
+            /// </summary>
+            /// <remarks>
+            /// This overload must be used for value types.
+            /// </remarks>
+            /// <param name="obj">the instance to access</param>
+            /// <param name="val">the new value of the property</param>
+            /// <exception cref="InvalidOperationException">if the property has no setter</exception>
+            public void Set(ref T obj, U val) => (setter ?? throw NoAccessor("setter"))(ref obj, val);
+            /// <summary>
+            /// Sets the value of the property on <paramref name="obj"/>.
+            /// </summary>
+            /// <remarks>
+            /// This overload cannot be safely used for value types. Use <see cref="Set(ref T, U)"/> instead.
+            /// </remarks>
+            /// <param name="obj">the instance to access</param>
+            /// <param name="val">the new value of the property</param>
+            /// <exception cref="InvalidOperationException">if the property has no setter</exception>
+            public void Set(T obj, U val) => (setter ?? throw NoAccessor("setter"))(ref obj, val);
+
+            private InvalidOperationException NoAccessor(string kind)
+                => new($"Property '{Name}' on {typeof(T)} has no {kind}");
+        }
+
+        // property name -> handle
+        private static readonly CopyOnWriteValueCache<string, Handle> handles = new();
 
-        private static (Getter get, Setter set) GetAccessors(string propName)
-            => props.GetOrAdd(propName, MakeAccessors);
+        /// <summary>
+        /// Gets a <see cref="Handle"/> for the property identified by <paramref name="name"/>.
+        /// </summary>
+        /// <param name="name">the name of the property</param>
+        /// <returns>a handle for the property</returns>
+        /// <exception cref="MissingMemberException">if the property does not exist</exception>
+        public static Handle GetHandle(string name)
+            => handles.GetOrAdd(name, n => new Handle(n, MakeAccessors(n)));
 
         /// <summary>
         /// Gets a <see cref="Getter"/> for the property identified by <paramref name="name"/>.
@@ -205,14 +371,14 @@ namespace IPA.Utilities
         /// <param name="name">the name of the property</param>
         /// <returns>a <see cref="Getter"/> that can access that property</returns>
         /// <exception cref="MissingMemberException">if the property does not exist</exception>
-        public static Getter GetGetter(string name) => GetAccessors(name).get;
+        public static Getter GetGetter(string name) => GetHandle(name).Getter;
         /// <summary>
         /// Gets a <see cref="Setter"/> for the property identified by <paramref name="name"/>.
         /// </summary>
         /// <param name="name">the name of the property</param>
         /// <returns>a <see cref="Setter"/> that can access that property</returns>
         /// <exception cref="MissingMemberException">if the property does not exist</exception>
-        public static Setter GetSetter(string name) => GetAccessors(name).set;
+        public static Setter GetSetter(string name) => GetHandle(name).Setter;
 
         /// <summary>
         /// Gets the value of the property identified by <paramref name="name"/> on <paramref name="obj"/>.
@@ -314,7 +480,7 @@ namespace IPA.Utilities
             return (TDelegate)Delegate.CreateDelegate(AccessorDelegateInfo<TDelegate>.Type, method, true);
         }
 
-        private static readonly SingleCreationValueCache<string, TDelegate> methods = new SingleCreationValueCache<string, TDelegate>();
+        private static readonly CopyOnWriteValueCache<string, TDelegate> methods = new();
 
         /// <summary>
         /// Gets a delegate to the named method with the signature specified by <typeparamref name="TDelegate"/>.
@@ -324,7 +490,7 @@ namespace IPA.Utilities
         /// <exception cref="MissingMethodException">if <paramref name="name"/> does not represent the name of a method with the given signature</exception>
         /// <exception cref="ArgumentException">if the method found returns a type incompatable with the return type of <typeparamref name="TDelegate"/></exception>
         public static TDelegate GetDelegate(string name)
-            => methods.GetOrAdd(name, MakeDelegate);
+            => methods.GetOrAdd(name, n => MakeDelegate(n)); // a lambda, so that the delegate is cached
     }
 
 }
@@ -0,0 +1,237 @@
+﻿#nullable enable
+using System;
+using System.Threading;
+
+namespace IPA.Utilities.Async
+{
+    /// <summary>
+    /// A bounded, lock-free, multi-producer single-consumer queue of value types.
+    /// </summary>
+    /// <remarks>
+    /// <para>
+    /// The storage is a ring of preallocated slots, each with a sequence number, so enqueueing and dequeueing never allocate.
+    /// Producers claim slots with a single CAS, and only the (single) consumer thread may dequeue.
+    /// </para>
+    /// <para>
+    /// When the ring is full, <see cref="Enqueue(in T)"/> applies back-pressure by waiting for the consumer to free space,
+    /// instead of dropping items or growing.
+    /// </para>
+    /// </remarks>
+    /// <typeparam name="T">the type of the items in the queue</typeparam>
+    internal sealed class BoundedMpscQueue<T>
+    {
+        private struct Slot
+        {
+            public int Sequence;
+            public T Item;
+        }
+
+        private readonly Slot[] slots;
+        private readonly int mask;
+
+        private int enqueuePos;
+        private int dequeuePos; // only touched by the consumer
+
+        private readonly ManualResetEventSlim itemsAvailable = new(false);
+        private readonly ManualResetEventSlim spaceAvailable = new(false);
+        private int consumerWaiting;
+        private int producersWaiting;
+        private volatile bool completed;
+
+        private const int ProducerWaitTimeout = 1;
+
+        /// <summary>
+        /// Creates a new queue with at least <paramref name="capacity"/> slots.
+        /// </summary>
+        /// <param name="capacity">the minimum capacity of the queue. This is rounded up to the next power of 2.</param>
+        public BoundedMpscQueue(int capacity)
+        {
+            if (capacity < 2)
+                throw new ArgumentOutOfRangeException(nameof(capacity));
+
+            var size = 2;
+            while (size < capacity) size <<= 1;
+
+            slots = new Slot[size];
+            mask = size - 1;
+            for (var i = 0; i < size; i++)
+                slots[i].Sequence = i;
+        }
+
+        /// <summary>
+        /// Gets the number of slots in the queue.
+        /// </summary>
+        public int Capacity => slots.Length;
+
+        /// <summary>
+        /// Gets an approximation of the number of items in the queue.
+        /// </summary>
+        public int Count => Math.Max(0, Volatile.Read(ref enqueuePos) - Volatile.Read(ref dequeuePos));
+
+        /// <summary>
+        /// Gets whether or not <see cref="CompleteAdding"/> has been called.
+        /// </summary>
+        public bool IsAddingCompleted => completed;
+
+        /// <summary>
+        /// Attempts to add an item to the queue without waiting.
+        /// </summary>
+        /// <param name="item">the item to add</param>
+        /// <returns><see langword="true"/> if the item was added, <see langword="false"/> if the queue was full or completed</returns>
+        public bool TryEnqueue(in T item)
+        {
+            if (completed) return false;
+            if (!TryEnqueueCore(in item)) return false;
+            WakeConsumer();
+            return true;
+        }
+
+        /// <summary>
+        /// Adds an item to the queue, waiting for space if it is full.
+        /// </summary>
+        /// <param name="item">the item to add</param>
+        /// <returns><see langword="true"/> if the item was added, <see langword="false"/> if the queue was completed</returns>
+        public bool Enqueue(in T item)
+        {
+            if (TryEnqueue(in item)) return true;
+
+            var spin = new SpinWait();
+            while (!spin.NextSpinWillYield)
+            {
+                spin.SpinOnce();
+                if (completed) return false;
+                if (TryEnqueue(in item)) return true;
+            }
+
+            _ = Interlocked.Increment(ref producersWaiting);
+            try
+            {
+                while (!completed)
+                {
+                    if (TryEnqueue(in item)) return true;
+                    WakeConsumer(force: true);
+                    _ = spaceAvailable.Wait(ProducerWaitTimeout);
+                }
+                return false;
+            }
+            finally
+            {
+                _ = Interlocked.Decrement(ref producersWaiting);
+            }
+        }
+
+        private bool TryEnqueueCore(in T item)
+        {
+            var pos = Volatile.Read(ref enqueuePos);
+            while (true)
+            {
+                ref var slot = ref slots[pos & mask];
+                var diff = Volatile.Read(ref slot.Sequence) - pos;
+                if (diff == 0)
+                {
+                    var prev = Interlocked.CompareExchange(ref enqueuePos, pos + 1, pos);
+                    if (prev == pos)
+                    {
+                        slot.Item = item;
+                        Volatile.Write(ref slot.Sequence, pos + 1);
+                        return true;
+                    }
+                    pos = prev;
+                }
+                else if (diff < 0)
+                    return false; // the consumer has not freed this slot yet, so we're full
+                else
+                    pos = Volatile.Read(ref enqueuePos);
+            }
+        }
+
+        private void WakeConsumer(bool force = false)
+        {
+            // the barrier orders the slot publish before the read of consumerWaiting, pairing with the one in WaitForItems
+            Interlocked.MemoryBarrier();
+            if ((force || Volatile.Read(ref consumerWaiting) != 0) && Interlocked.Exchange(ref consumerWaiting, 0) != 0)
+                itemsAvailable.Set();
+        }
+
+        private bool HasItem()
+        {
+            var pos = dequeuePos;
+            return Volatile.Read(ref slots[pos & mask].Sequence) - (pos + 1) >= 0;
+        }
+
+        /// <summary>
+        /// Attempts to remove an item from the queue. Must only be called from the consumer thread.
+        /// </summary>
+        /// <param name="item">the item that was removed</param>
+        /// <returns><see langword="true"/> if an item was removed, <see langword="false"/> if the queue was empty</returns>
+        public bool TryDequeue(out T item)
+        {
+            var pos = dequeuePos;
+            ref var slot = ref slots[pos & mask];
+            if (Volatile.Read(ref slot.Sequence) - (pos + 1) < 0)
+            {
+                item = default!;
+                return false;
+            }
+
+            item = slot.Item;
+            slot.Item = default!;
+            Volatile.Write(ref slot.Sequence, pos + mask + 1);
+            Volatile.Write(ref dequeuePos, pos + 1);
+            return true;
+        }
+
+        /// <summary>
+        /// Removes as many items as are available, up to the length of <paramref name="buffer"/>. Must only be called from the consumer thread.
+        /// </summary>
+        /// <param name="buffer">the buffer to dequeue into</param>
+        /// <returns>the number of items written to <paramref name="buffer"/></returns>
+        public int DequeueBatch(T[] buffer)
+        {
+            if (Volatile.Read(ref producersWaiting) != 0)
+                spaceAvailable.Reset();
+
+            var count = 0;
+            while (count < buffer.Length && TryDequeue(out buffer[count]))
+                count++;
+
+            if (count > 0 && Volatile.Read(ref producersWaiting) != 0)
+                spaceAvailable.Set();
+            return count;
+        }
+
+        /// <summary>
+        /// Waits until there are items available in the queue. Must only be called from the consumer thread.
+        /// </summary>
+        /// <param name="millisecondsTimeout">the maximum time to wait, or <see cref="Timeout.Infinite"/></param>
+        /// <returns><see langword="true"/> if there are items available, <see langword="false"/> if the wait timed out
+        /// or the queue is completed and empty</returns>
+        public bool WaitForItems(int millisecondsTimeout)
+        {
+            if (HasItem()) return true;
+            if (completed) return false;
+
+            itemsAvailable.Reset();
+            _ = Interlocked.Exchange(ref consumerWaiting, 1);
+            if (HasItem() || completed)
+            {
+                _ = Interlocked.Exchange(ref consumerWaiting, 0);
+                return HasItem();
+            }
+
+            _ = itemsAvailable.Wait(millisecondsTimeout);
+            _ = Interlocked.Exchange(ref consumerWaiting, 0);
+            return HasItem();
+        }
+
+        /// <summary>
+        /// Marks the queue as not accepting any more items, and wakes the consumer and any waiting producers.
+        /// </summary>
+        public void CompleteAdding()
+        {
+            completed = true;
+            itemsAvailable.Set();
+            spaceAvailable.Set();
+        }
+    }
+}
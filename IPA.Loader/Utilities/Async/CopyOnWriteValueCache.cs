@@ -0,0 +1,71 @@
+﻿#nullable enable
+using System;
+using System.Collections.Generic;
+using System.Threading;
+
+namespace IPA.Utilities.Async
+{
+    /// <summary>
+    /// A thread-safe value cache whose values are created only once ever, for caches that are read far more often
+    /// than they are added to.
+    /// </summary>
+    /// <remarks>
+    /// <para>
+    /// Reads are a lookup in an immutable <see cref="Dictionary{TKey, TValue}"/> snapshot, with no locks and no
+    /// per-entry wait handles like <see cref="SingleCreationValueCache{TKey, TValue}"/> has.
+    /// </para>
+    /// <para>
+    /// Values are created while holding a single lock, and each addition copies the snapshot, so this is only suitable
+    /// for small caches with cheap-ish creators, like the accessors for the members of one type.
+    /// </para>
+    /// </remarks>
+    /// <typeparam name="TKey">the key type of the cache</typeparam>
+    /// <typeparam name="TValue">the value type of the cache</typeparam>
+    internal sealed class CopyOnWriteValueCache<TKey, TValue> where TKey : notnull
+    {
+        private readonly object createLock = new();
+        private readonly IEqualityComparer<TKey>? comparer;
+        private Dictionary<TKey, TValue> values;
+
+        public CopyOnWriteValueCache(IEqualityComparer<TKey>? comparer = null)
+        {
+            this.comparer = comparer;
+            values = new Dictionary<TKey, TValue>(comparer);
+        }
+
+        public int Count => Volatile.Read(ref values).Count;
+
+        public bool TryGetValue(TKey key, out TValue value)
+            => Volatile.Read(ref values).TryGetValue(key, out value!);
+
+        /// <summary>
+        /// Gets the value associated with <paramref name="key"/>, creating it with <paramref name="creator"/> if it
+        /// does not exist yet.
+        /// </summary>
+        /// <remarks>
+        /// If <paramref name="creator"/> throws, nothing is added, and the next call for the same key tries again.
+        /// </remarks>
+        /// <param name="key">the key to search for</param>
+        /// <param name="creator">the delegate to use to create the value if it does not exist</param>
+        /// <returns>the value that was found, or the result of <paramref name="creator"/></returns>
+        public TValue GetOrAdd(TKey key, Func<TKey, TValue> creator)
+        {
+            if (Volatile.Read(ref values).TryGetValue(key, out var value))
+                return value;
+
+            lock (createLock)
+            {
+                if (values.TryGetValue(key, out value))
+                    return value; // created while we were waiting for the lock
+
+                value = creator(key);
+                var next = new Dictionary<TKey, TValue>(values, comparer)
+                {
+                    [key] = value
+                };
+                Volatile.Write(ref values, next);
+                return value;
+            }
+        }
+    }
+}
@@ -5,7 +5,7 @@ using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Diagnostics;
 using System.Linq;
-using System.Runtime.CompilerServices;
+using System.Threading;
 using System.Threading.Tasks;
 
 namespace IPA.Utilities.Async
@@ -26,42 +26,102 @@ namespace IPA.Utilities.Async
         /// <value>a factory for creating tasks on the default scheduler</value>
         public static TaskFactory Factory { get; } = new TaskFactory(Default);
 
-        private readonly ConcurrentQueue<QueueItem> tasks = new();
-        private static readonly ConditionalWeakTable<Task, QueueItem> itemTable = new();
-
-        private class QueueItem : IEquatable<Task>, IEquatable<QueueItem>
+        /// <summary>
+        /// The lanes that work can be queued to. Each time the scheduler runs, it drains <see cref="High"/> before
+        /// <see cref="Normal"/>, and <see cref="Normal"/> before <see cref="Low"/>.
+        /// </summary>
+        public enum Priority
         {
-            private bool hasTask;
-            public bool HasTask
-            {
-                get => hasTask;
-                set
-                {
-                    hasTask = value;
-                    if (!hasTask) Task = null;
-                }
-            }
-
-            public Task? Task { get; private set; }
+            /// <summary>
+            /// Work that should run as soon as possible, ahead of everything else.
+            /// </summary>
+            High,
+            /// <summary>
+            /// The lane that tasks scheduled directly to this scheduler go to.
+            /// </summary>
+            Normal,
+            /// <summary>
+            /// Work that can wait until nothing else is queued.
+            /// </summary>
+            Low,
+        }
 
-            public Action? Action { get; private set; }
+        // a task or an action; a struct so that queueing doesn't allocate
+        private readonly struct QueueItem
+        {
+            public readonly Task? Task;
+            public readonly Action? Action;
 
             public QueueItem(Task task)
             {
-                HasTask = true;
                 Task = task;
+                Action = null;
             }
 
             public QueueItem(Action action)
             {
-                HasTask = true;
+                Task = null;
                 Action = action;
             }
+        }
+
+        private readonly ConcurrentQueue<QueueItem>[] lanes =
+        {
+            new(), new(), new(), // indexed by Priority
+        };
+        private readonly LaneScheduler?[] laneSchedulers = new LaneScheduler?[3];
+        private int backlog;
 
-            public bool Equals(Task? other) => other is not null && HasTask && other.Equals(Task);
-            public bool Equals(QueueItem other) => other.HasTask == HasTask && Equals(other.Task);
+        /// <summary>
+        /// Per-frame statistics for a <see cref="UnityMainThreadTaskScheduler"/>.
+        /// </summary>
+        public readonly struct FrameStats
+        {
+            /// <summary>
+            /// Gets the number of tasks and actions that were run.
+            /// </summary>
+            /// <value>the number of tasks run in the frame</value>
+            public int TasksRun { get; }
+            /// <summary>
+            /// Gets the amount of time spent running them.
+            /// </summary>
+            /// <value>the time used in the frame</value>
+            public TimeSpan TimeUsed { get; }
+            /// <summary>
+            /// Gets the amount of time the scheduler allowed itself for the frame.
+            /// </summary>
+            /// <value>the budget for the frame</value>
+            public TimeSpan Budget { get; }
+            /// <summary>
+            /// Gets the number of items still queued at the end of the frame.
+            /// </summary>
+            /// <value>the backlog depth at the end of the frame</value>
+            public int Backlog { get; }
+
+            internal FrameStats(int tasksRun, TimeSpan timeUsed, TimeSpan budget, int backlog)
+            {
+                TasksRun = tasksRun;
+                TimeUsed = timeUsed;
+                Budget = budget;
+                Backlog = backlog;
+            }
         }
 
+        /// <summary>
+        /// Gets the statistics for the last time the scheduler ran.
+        /// </summary>
+        /// <value>the statistics of the last frame</value>
+        public FrameStats LastFrameStats { get; private set; }
+
+        /// <summary>
+        /// Gets the number of items currently queued across all lanes.
+        /// </summary>
+        /// <remarks>
+        /// Tasks that were queued and then executed inline are counted until the scheduler reaches them.
+        /// </remarks>
+        /// <value>the number of queued items</value>
+        public int Backlog => Volatile.Read(ref backlog);
+
         /// <summary>
         /// Gets whether or not this scheduler is currently executing tasks.
         /// </summary>
@@ -108,6 +168,81 @@ namespace IPA.Utilities.Async
             }
         }
 
+        /// <summary>
+        /// Gets or sets whether the scheduler sizes its time budget from the measured frame time, instead of using
+        /// <see cref="YieldAfterTime"/> and <see cref="YieldAfterTasks"/>.
+        /// </summary>
+        /// <remarks>
+        /// <para>
+        /// The time between runs of the scheduler is the time the rest of the frame took. The scheduler tracks that
+        /// (following increases immediately, and decreases slowly), and uses half of what is left of
+        /// <see cref="TargetFrameTime"/> as its budget, clamped between <see cref="MinimumBudget"/> and
+        /// <see cref="MaximumBudget"/>. The task count limit does not apply in this mode.
+        /// </para>
+        /// <para>
+        /// That time includes any time spent waiting for vsync or for the VR compositor, so in a frame-locked game the
+        /// rest of the frame always seems to take the whole frame, and the budget stays at <see cref="MinimumBudget"/>.
+        /// Only turn this on when the frame rate is not locked. This is off by default.
+        /// </para>
+        /// <para>
+        /// The scheduler always runs at least one item each time it runs, so that it makes progress even in frames
+        /// with no slack.
+        /// </para>
+        /// </remarks>
+        /// <value><see langword="true"/> to use an adaptive budget, <see langword="false"/> to use the fixed limits</value>
+        public bool AdaptiveBudget { get; set; } = false;
+
+        private TimeSpan targetFrameTime = TimeSpan.FromTicks(TimeSpan.TicksPerSecond / 90);
+        /// <summary>
+        /// Gets or sets the frame time that <see cref="AdaptiveBudget"/> tries to stay within. Default is that of 90 FPS.
+        /// </summary>
+        /// <value>the target frame time</value>
+        public TimeSpan TargetFrameTime
+        {
+            get => targetFrameTime;
+            set
+            {
+                ThrowIfDisposed();
+                if (value <= TimeSpan.Zero)
+                    throw new ArgumentException("Value must be greater than zero", nameof(value));
+                targetFrameTime = value;
+            }
+        }
+
+        private TimeSpan minimumBudget = TimeSpan.FromMilliseconds(.1);
+        /// <summary>
+        /// Gets or sets the smallest budget <see cref="AdaptiveBudget"/> will use. Default is 0.1ms.
+        /// </summary>
+        /// <value>the minimum adaptive budget</value>
+        public TimeSpan MinimumBudget
+        {
+            get => minimumBudget;
+            set
+            {
+                ThrowIfDisposed();
+                if (value <= TimeSpan.Zero)
+                    throw new ArgumentException("Value must be greater than zero", nameof(value));
+                minimumBudget = value;
+            }
+        }
+
+        private TimeSpan maximumBudget = TimeSpan.FromMilliseconds(4);
+        /// <summary>
+        /// Gets or sets the largest budget <see cref="AdaptiveBudget"/> will use. Default is 4ms.
+        /// </summary>
+        /// <value>the maximum adaptive budget</value>
+        public TimeSpan MaximumBudget
+        {
+            get => maximumBudget;
+            set
+            {
+                ThrowIfDisposed();
+                if (value <= TimeSpan.Zero)
+                    throw new ArgumentException("Value must be greater than zero", nameof(value));
+                maximumBudget = value;
+            }
+        }
+
         /// <summary>
         /// When used as a Unity coroutine, runs the scheduler. Otherwise, this is an invalid call.
         /// </summary>
@@ -136,42 +271,157 @@ namespace IPA.Utilities.Async
             IsRunning = true;
             yield return null; // yield immediately
 
-            var sw = new Stopwatch();
+            var batch = new Stopwatch();
+            var sinceLastBatch = new Stopwatch();
+            long otherWork = -1; // the smoothed time the rest of the frame takes, in TimeSpan ticks
 
             try
             {
                 while (!Cancelling)
                 {
-                    if (!tasks.IsEmpty)
+                    TimeSpan budget;
+                    int maxTasks;
+                    if (AdaptiveBudget)
                     {
-                        var yieldAfter = YieldAfterTasks;
-                        sw.Start();
-                        for (int i = 0; i < yieldAfter && !tasks.IsEmpty 
-                                                       && sw.Elapsed < YieldAfterTime; i++)
+                        maxTasks = int.MaxValue;
+                        if (!sinceLastBatch.IsRunning)
+                            budget = MinimumBudget; // nothing measured yet
+                        else
                         {
-                            QueueItem task;
-                            do if (!tasks.TryDequeue(out task)) goto exit; // try dequeue, if we can't exit
-                            while (!task.HasTask); // if the dequeued task is empty, try again
-
-                            if (task.Task is not null)
-                            {
-                                _ = TryExecuteTask(task.Task);
-                            }
-                            task.Action?.Invoke();
+                            var sample = sinceLastBatch.Elapsed.Ticks;
+                            // react to spikes right away, but let the estimate come down gradually
+                            otherWork = otherWork < 0 || sample > otherWork ? sample : otherWork + (sample - otherWork) / 8;
+                            var slack = TimeSpan.FromTicks((TargetFrameTime.Ticks - otherWork) / 2);
+                            budget = slack < MinimumBudget ? MinimumBudget
+                                   : slack > MaximumBudget ? MaximumBudget
+                                   : slack;
                         }
-                        exit:
-                        sw.Reset();
                     }
+                    else
+                    {
+                        maxTasks = YieldAfterTasks;
+                        budget = YieldAfterTime;
+                    }
+
+                    batch.Reset();
+                    batch.Start();
+                    var run = RunBatch(budget, maxTasks, batch);
+                    batch.Stop();
+
+                    LastFrameStats = new(run, batch.Elapsed, budget, Backlog);
+
+                    sinceLastBatch.Reset();
+                    sinceLastBatch.Start();
                     yield return null;
                 }
             }
             finally
             {
-                sw.Reset();
+                batch.Reset();
+                sinceLastBatch.Reset();
                 IsRunning = false;
             }
         }
 
+        private int RunBatch(TimeSpan budget, int maxTasks, Stopwatch sw)
+        {
+            var run = 0;
+            while (run < maxTasks && (run == 0 || sw.Elapsed < budget))
+            {
+                if (!TryDequeue(out var item, out var priority))
+                    break;
+
+                if (item.Task is not null)
+                {
+                    // false if it was already run inline, which doesn't count
+                    if (!Execute(item.Task, priority)) continue;
+                }
+                else
+                {
+                    item.Action!.Invoke();
+                }
+                run++;
+            }
+            return run;
+        }
+
+        private bool TryDequeue(out QueueItem item, out Priority priority)
+        {
+            for (var i = 0; i < lanes.Length; i++)
+            {
+                if (lanes[i].TryDequeue(out item))
+                {
+                    _ = Interlocked.Decrement(ref backlog);
+                    priority = (Priority)i;
+                    return true;
+                }
+            }
+
+            item = default;
+            priority = default;
+            return false;
+        }
+
+        private bool Execute(Task task, Priority priority)
+            => priority == Priority.Normal
+                ? TryExecuteTask(task)
+                : laneSchedulers[(int)priority]!.Execute(task);
+
+        private void Enqueue(QueueItem item, Priority priority)
+        {
+            ThrowIfDisposed();
+
+            _ = Interlocked.Increment(ref backlog);
+            lanes[(int)priority].Enqueue(item);
+        }
+
+        /// <summary>
+        /// Gets a <see cref="TaskScheduler"/> that queues its tasks to the given lane of this scheduler.
+        /// </summary>
+        /// <remarks>
+        /// The scheduler for <see cref="Priority.Normal"/> is this scheduler itself.
+        /// </remarks>
+        /// <param name="priority">the lane to queue tasks to</param>
+        /// <returns>a scheduler for <paramref name="priority"/></returns>
+        /// <exception cref="ObjectDisposedException">if this scheduler is disposed</exception>
+        public TaskScheduler GetScheduler(Priority priority)
+        {
+            ThrowIfDisposed();
+
+            if (priority == Priority.Normal) return this;
+            if (priority is < Priority.High or > Priority.Low)
+                throw new ArgumentOutOfRangeException(nameof(priority));
+
+            var idx = (int)priority;
+            if (laneSchedulers[idx] is { } sched) return sched;
+            _ = Interlocked.CompareExchange(ref laneSchedulers[idx], new LaneScheduler(this, priority), null);
+            return laneSchedulers[idx]!;
+        }
+
+        private sealed class LaneScheduler : TaskScheduler
+        {
+            private readonly UnityMainThreadTaskScheduler owner;
+            private readonly Priority priority;
+
+            public LaneScheduler(UnityMainThreadTaskScheduler owner, Priority priority)
+            {
+                this.owner = owner;
+                this.priority = priority;
+            }
+
+            public bool Execute(Task task) => TryExecuteTask(task);
+
+            protected override IEnumerable<Task> GetScheduledTasks() => owner.GetScheduledTasks(priority);
+
+            protected override void QueueTask(Task task) => owner.Enqueue(new(task), priority);
+
+            protected override bool TryExecuteTaskInline(Task task, bool taskWasPreviouslyQueued)
+            {
+                owner.ThrowIfDisposed();
+                return UnityGame.OnMainThread && TryExecuteTask(task);
+            }
+        }
+
         /// <summary>
         /// Cancels the scheduler. If the scheduler is currently executing tasks, that batch will finish first.
         /// All remaining tasks will be left in the queue.
@@ -191,8 +441,10 @@ namespace IPA.Utilities.Async
         /// </summary>
         /// <returns>nothing</returns>
         /// <exception cref="NotSupportedException">Always.</exception>
-        protected override IEnumerable<Task> GetScheduledTasks()
-            => tasks.ToArray().Where(q => q.HasTask).Select(q => q.Task).NonNull().ToArray();
+        protected override IEnumerable<Task> GetScheduledTasks() => GetScheduledTasks(Priority.Normal);
+
+        private IEnumerable<Task> GetScheduledTasks(Priority priority)
+            => lanes[(int)priority].ToArray().Select(q => q.Task).NonNull().Where(t => t.Status == TaskStatus.WaitingToRun).ToArray();
 
         /// <summary>
         /// Queues a given <see cref="Task"/> to this scheduler. The <see cref="Task"/> <i>must</i> be
@@ -200,21 +452,9 @@ namespace IPA.Utilities.Async
         /// </summary>
         /// <param name="task">the <see cref="Task"/> to queue</param>
         /// <exception cref="ObjectDisposedException">Thrown if this object has already been disposed.</exception>
-        protected override void QueueTask(Task task)
-        {
-            ThrowIfDisposed();
+        protected override void QueueTask(Task task) => Enqueue(new(task), Priority.Normal);
 
-            var item = new QueueItem(task);
-            itemTable.Add(task, item);
-            tasks.Enqueue(item);
-        }
-
-        internal void QueueAction(Action action)
-        {
-            ThrowIfDisposed();
-
-            tasks.Enqueue(new(action));
-        }
+        internal void QueueAction(Action action, Priority priority = Priority.Normal) => Enqueue(new(action), priority);
 
         /// <summary>
         /// Runs the task inline if the current thread is the Unity main thread.
@@ -229,16 +469,7 @@ namespace IPA.Utilities.Async
 
             if (!UnityGame.OnMainThread) return false;
 
-            if (taskWasPreviouslyQueued)
-            {
-                if (itemTable.TryGetValue(task, out var item))
-                {
-                    if (!item.HasTask) return false;
-                    item.HasTask = false;
-                }
-                else return false; // if we couldn't remove it, its not in our queue, so it already ran
-            }
-
+            // if it was queued, it stays in the queue, but TryExecuteTask won't run a task twice
             return TryExecuteTask(task);
         }
 
@@ -0,0 +1,90 @@
+﻿using System;
+using IPA.Utilities;
+using IPA.Utilities.Async;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace IPA.Tests
+{
+    public class AccessorBenchmark
+    {
+        public class Target
+        {
+            public int Public;
+#pragma warning disable CS0649 // only written through the accessors
+            private int hidden;
+#pragma warning restore CS0649
+            private int Property { get; set; }
+
+            public int Hidden => hidden;
+            public int PropertyValue => Property;
+        }
+
+        private const int Iterations = 1000000;
+
+        private static readonly FieldAccessor<Target, int>.Handle HiddenHandle = FieldAccessor<Target, int>.GetHandle("hidden");
+        private static readonly PropertyAccessor<Target, int>.Handle PropertyHandle = PropertyAccessor<Target, int>.GetHandle("Property");
+
+        private readonly ITestOutputHelper output;
+
+        public AccessorBenchmark(ITestOutputHelper output)
+        {
+            this.output = output;
+        }
+
+        [Fact]
+        public void HandlesMatchByName()
+        {
+            var target = new Target();
+
+            HiddenHandle.Set(target, 5);
+            Assert.Equal(5, target.Hidden);
+            FieldAccessor<Target, int>.Set(target, "hidden", 6);
+            Assert.Equal(6, HiddenHandle.Get(target));
+            Assert.Same(HiddenHandle, FieldAccessor<Target, int>.GetHandle("hidden"));
+
+            PropertyHandle.Set(target, 7);
+            Assert.Equal(7, target.PropertyValue);
+            Assert.Equal(7, PropertyAccessor<Target, int>.Get(target, "Property"));
+
+            Assert.Throws<MissingFieldException>(() => FieldAccessor<Target, int>.GetHandle("missing"));
+        }
+
+        [Fact]
+        public void PerAccess()
+        {
+            var target = new Target();
+            var sum = 0L;
+
+            var raw = Benchmark.Report(output, "raw field", Iterations, i => { target.Public = i; sum += target.Public; });
+            var handle = Benchmark.Report(output, "field handle", Iterations, i => { HiddenHandle.Set(target, i); sum += HiddenHandle.Get(target); });
+            var byName = Benchmark.Report(output, "field by name", Iterations, i =>
+            {
+                FieldAccessor<Target, int>.Set(target, "hidden", i);
+                sum += FieldAccessor<Target, int>.Get(target, "hidden");
+            });
+
+            // the lookup the by-name methods did before they went through handles
+            var oldCache = new SingleCreationValueCache<string, FieldAccessor<Target, int>.Accessor>();
+            var oldByName = Benchmark.Report(output, "field by name, old cache", Iterations, i =>
+            {
+                oldCache.GetOrAdd("hidden", FieldAccessor<Target, int>.GetAccessor)(ref target) = i;
+                sum += oldCache.GetOrAdd("hidden", FieldAccessor<Target, int>.GetAccessor)(ref target);
+            });
+
+            Benchmark.Report(output, "property handle", Iterations, i => { PropertyHandle.Set(target, i); sum += PropertyHandle.Get(target); });
+            Benchmark.Report(output, "property by name", Iterations, i =>
+            {
+                PropertyAccessor<Target, int>.Set(target, "Property", i);
+                sum += PropertyAccessor<Target, int>.Get(target, "Property");
+            });
+
+            output.WriteLine("handle: {0:F1}x raw; by name: {1:F1}x handle; old by name: {2:F1}x by name",
+                (double)handle.Ticks / raw.Ticks, (double)byName.Ticks / handle.Ticks, (double)oldByName.Ticks / byName.Ticks);
+
+            Assert.Equal(Iterations - 1, target.Hidden);
+            Assert.Equal(Iterations - 1, target.PropertyValue);
+            Assert.NotEqual(0, sum);
+        }
+    }
+}
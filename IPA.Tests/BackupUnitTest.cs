@@ -0,0 +1,121 @@
+﻿using System;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using IPA.Patcher;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace IPA.Tests
+{
+    public class BackupUnitTest : IDisposable
+    {
+        private readonly ITestOutputHelper output;
+        private readonly string root = Path.Combine(Path.GetTempPath(), "IPA.Tests-" + Guid.NewGuid().ToString("N"));
+        private readonly DirectoryInfo game;
+        private readonly PatchContext context;
+
+        public BackupUnitTest(ITestOutputHelper output)
+        {
+            this.output = output;
+            game = Directory.CreateDirectory(Path.Combine(root, "Game"));
+            context = PatchContext.Create(Path.Combine(game.FullName, "Game.exe"), Path.Combine(root, "IPA"));
+        }
+
+        public void Dispose()
+        {
+            Directory.Delete(root, true);
+        }
+
+        [Fact]
+        public void FailedBackupCanBeRetried()
+        {
+            var file = new FileInfo(Path.Combine(game.FullName, "a.txt"));
+            File.WriteAllText(file.FullName, "original");
+
+            // a file where the object store should be makes storing fail
+            var objects = Path.Combine(context.BackupPath, BackupUnit.ObjectsDirName);
+            File.WriteAllText(objects, "");
+            var unit = new BackupUnit(context);
+            Assert.ThrowsAny<IOException>(() => unit.Add(file));
+
+            File.Delete(objects);
+            unit.Add(file);
+
+            File.WriteAllText(file.FullName, "changed");
+            unit.Restore();
+            Assert.Equal("original", File.ReadAllText(file.FullName));
+        }
+
+        private static long SizeOf(string dir)
+            => Directory.Exists(dir) ? new DirectoryInfo(dir).EnumerateFiles("*", SearchOption.AllDirectories).Sum(f => f.Length) : 0;
+
+        [Fact]
+        public void DiskUsageAndRestoreTime()
+        {
+            const int fileCount = 300;
+            const int fileSize = 64 * 1024;
+            const int installs = 2;
+
+            var random = new Random(1);
+            var relativePaths = Enumerable.Range(0, fileCount).Select(i => Path.Combine("Data" + i % 10, $"file{i}.bin")).ToArray();
+            var data = new byte[fileSize];
+            foreach (var path in relativePaths)
+            {
+                random.NextBytes(data);
+                var full = Path.Combine(game.FullName, path);
+                Directory.CreateDirectory(Path.GetDirectoryName(full));
+                File.WriteAllBytes(full, data);
+            }
+
+            // the old scheme: every install kept a full copy of what it replaced, and listed it in its manifest
+            var legacyRoot = Path.Combine(root, "Legacy");
+            for (var i = 0; i < installs; i++)
+            {
+                var unitDir = Path.Combine(legacyRoot, "legacy" + i);
+                foreach (var path in relativePaths)
+                {
+                    var backup = new FileInfo(Path.Combine(unitDir, path));
+                    backup.Directory.Create();
+                    File.Copy(Path.Combine(game.FullName, path), backup.FullName);
+                }
+                File.WriteAllLines(Path.Combine(unitDir, "$manifest$.txt"), relativePaths);
+            }
+
+            var units = new BackupUnit[installs];
+            for (var i = 0; i < installs; i++)
+            {
+                if (i > 0) Thread.Sleep(1100); // units are named by the second they were made in
+                units[i] = new BackupUnit(context);
+                foreach (var path in relativePaths)
+                    units[i].Add(Path.Combine(game.FullName, path));
+            }
+
+            output.WriteLine("{0} installs backing up {1} files of {2} KiB:", installs, fileCount, fileSize / 1024);
+            output.WriteLine("  full copies   {0,10:F1} MiB", SizeOf(legacyRoot) / (1024.0 * 1024));
+            output.WriteLine("  object store  {0,10:F1} MiB", SizeOf(context.BackupPath) / (1024.0 * 1024));
+
+            // a tenth of the files were replaced since, which is about what a mod install touches
+            void ReplaceSome()
+            {
+                foreach (var path in relativePaths.Where((p, i) => i % 10 == 0))
+                    File.WriteAllText(Path.Combine(game.FullName, path), "replaced");
+            }
+
+            ReplaceSome();
+            var legacy = BackupUnit.FromDirectory(new DirectoryInfo(Path.Combine(legacyRoot, "legacy" + (installs - 1))), context);
+            var sw = Stopwatch.StartNew();
+            legacy.Restore();
+            output.WriteLine("  restore from full copies   {0,8:F1} ms", sw.Elapsed.TotalMilliseconds);
+
+            ReplaceSome();
+            sw.Restart();
+            units[installs - 1].Restore();
+            output.WriteLine("  restore from object store  {0,8:F1} ms", sw.Elapsed.TotalMilliseconds);
+
+            foreach (var path in relativePaths.Where((p, i) => i % 10 == 0))
+                Assert.Equal(fileSize, new FileInfo(Path.Combine(game.FullName, path)).Length);
+        }
+    }
+}
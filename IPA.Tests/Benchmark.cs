@@ -0,0 +1,34 @@
+﻿using System;
+using System.Diagnostics;
+using Xunit.Abstractions;
+
+namespace IPA.Tests
+{
+    /// <summary>
+    /// Just enough timing for the benchmark tests to report how their cases compare. The numbers go to the test
+    /// output, and are not asserted on.
+    /// </summary>
+    internal static class Benchmark
+    {
+        public static TimeSpan Time(int iterations, Action<int> body)
+        {
+            body(0); // JIT it first
+            GC.Collect();
+            GC.WaitForPendingFinalizers();
+
+            var sw = Stopwatch.StartNew();
+            for (var i = 0; i < iterations; i++)
+                body(i);
+            sw.Stop();
+            return sw.Elapsed;
+        }
+
+        public static TimeSpan Report(ITestOutputHelper output, string name, int iterations, Action<int> body)
+        {
+            var time = Time(iterations, body);
+            output.WriteLine("{0,-32} {1,12:F1} ns/op  ({2} ops in {3:F1} ms)",
+                name, time.Ticks * 100.0 / iterations, iterations, time.TotalMilliseconds);
+            return time;
+        }
+    }
+}
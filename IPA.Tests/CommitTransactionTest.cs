@@ -0,0 +1,138 @@
+﻿using System;
+using System.Collections;
+using System.Collections.Generic;
+using System.Threading.Tasks;
+using IPA.Loader;
+using IPA.Utilities;
+using IPA.Utilities.Async;
+using Xunit;
+
+namespace IPA.Tests
+{
+    [Collection("Plugin state")]
+    public class CommitTransactionTest : IDisposable
+    {
+        private readonly List<string> calls = new List<string>();
+        private readonly IEnumerator scheduler;
+
+        public CommitTransactionTest()
+        {
+            UnityGame.SetMainThread();
+            DisabledConfig.Instance = new DisabledConfig();
+            scheduler = UnityMainThreadTaskScheduler.Default.Coroutine();
+            Assert.True(scheduler.MoveNext());
+        }
+
+        public void Dispose()
+        {
+            UnityMainThreadTaskScheduler.Default.Cancel();
+            while (scheduler.MoveNext()) { }
+        }
+
+        private static PluginMetadata Plugin(string name, params PluginMetadata[] dependencies)
+        {
+            var meta = new PluginMetadata
+            {
+                Manifest = new PluginManifest { Name = name, Id = name },
+                RuntimeOptions = RuntimeOptions.DynamicInit,
+            };
+            foreach (var dep in dependencies)
+                meta.Dependencies.Add(dep);
+            return meta;
+        }
+
+        private PluginExecutor Executor(PluginMetadata meta, Func<Task> enable = null, Func<Task> disable = null)
+            => new PluginExecutor(meta,
+                () =>
+                {
+                    calls.Add("enable " + meta.Name);
+                    return enable?.Invoke() ?? Task.CompletedTask;
+                },
+                () =>
+                {
+                    calls.Add("disable " + meta.Name);
+                    return disable?.Invoke() ?? Task.CompletedTask;
+                });
+
+        private void RunMainThreadUntil(Func<bool> condition)
+        {
+            for (var i = 0; i < 100 && !condition(); i++)
+                Assert.True(scheduler.MoveNext());
+            Assert.True(condition());
+        }
+
+        private static Task Commit(Action<StateTransitionTransaction> change)
+        {
+            var transaction = PluginManager.PluginStateTransaction();
+            change(transaction);
+            return transaction.Commit();
+        }
+
+        [Fact]
+        public void DisablesDependentsFirstAndIndependentPluginsConcurrently()
+        {
+            var a = Plugin("A");
+            var b = Plugin("B", a);
+            var c = Plugin("C");
+            var disableA = new TaskCompletionSource<object>();
+            PluginManager.SetPlugins(new[] { Executor(a, disable: () => disableA.Task), Executor(b), Executor(c) });
+
+            var done = Commit(t =>
+            {
+                t.Disable(a, autoDependents: true);
+                t.Disable(c);
+            });
+
+            // C doesn't wait for A's disable, which waited for B's
+            Assert.Equal(new[] { "disable B", "disable A", "disable C" }, calls);
+            Assert.False(done.IsCompleted);
+            Assert.True(PluginManager.IsDisabled(a));
+            Assert.Throws<InvalidOperationException>(() => { _ = Commit(t => t.Enable(a)); });
+
+            disableA.SetResult(null);
+            RunMainThreadUntil(() => done.IsCompleted);
+            Assert.Equal(TaskStatus.RanToCompletion, done.Status);
+
+            calls.Clear();
+            done = Commit(t => t.Enable(b, autoDeps: true));
+            Assert.Equal(TaskStatus.RanToCompletion, done.Status);
+            Assert.Equal(new[] { "enable A", "enable B" }, calls);
+        }
+
+        [Fact]
+        public void DefersOnlyPluginsWaitingOnAsynchronousEnables()
+        {
+            var a = Plugin("A");
+            var b = Plugin("B", a);
+            var c = Plugin("C");
+            var enableA = new TaskCompletionSource<object>();
+            PluginManager.SetPlugins(new[] { Executor(a, enable: () => enableA.Task), Executor(b), Executor(c) });
+            Assert.Equal(TaskStatus.RanToCompletion, Commit(t =>
+            {
+                t.Disable(a, autoDependents: true);
+                t.Disable(c);
+            }).Status);
+            calls.Clear();
+
+            var done = Commit(t =>
+            {
+                t.Enable(b, autoDeps: true);
+                t.Enable(c);
+            });
+
+            // A and C are enabled right away, and B waits for A's enable method
+            Assert.Equal(new[] { "enable A", "enable C" }, calls);
+            Assert.True(PluginManager.IsEnabled(a));
+            Assert.True(PluginManager.IsDisabled(b));
+            Assert.Throws<InvalidOperationException>(() => { _ = Commit(t => t.Enable(b)); });
+            // C was not deferred, so it can be changed again
+            Assert.Equal(TaskStatus.RanToCompletion, Commit(t => t.Disable(c)).Status);
+
+            enableA.SetResult(null);
+            RunMainThreadUntil(() => done.IsCompleted);
+            Assert.Equal(TaskStatus.RanToCompletion, done.Status);
+            Assert.Equal(new[] { "enable A", "enable C", "disable C", "enable B" }, calls);
+            Assert.True(PluginManager.IsEnabled(b));
+        }
+    }
+}
@@ -0,0 +1,101 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.CompilerServices;
+using IPA.Loader.Composite;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace IPA.Tests
+{
+    public class CompositeHookBenchmark
+    {
+        public interface IFramePlugin
+        {
+            string Name { get; }
+            void OnUpdate();
+            void OnLevelWasLoaded(int level);
+        }
+
+        // most plugins don't do anything every frame
+        public class IdlePlugin : IFramePlugin
+        {
+            public string Name { get; }
+            public IdlePlugin(string name) => Name = name;
+            public void OnUpdate() { }
+            public void OnLevelWasLoaded(int level) { }
+        }
+
+        public class BusyPlugin : IFramePlugin
+        {
+            public string Name { get; }
+            public int Updates;
+            public int LastLevel = -1;
+            public BusyPlugin(string name) => Name = name;
+            [MethodImpl(MethodImplOptions.NoInlining)]
+            public void OnUpdate() => Updates++;
+            public void OnLevelWasLoaded(int level) => LastLevel = level;
+        }
+
+        private const int PluginCount = 400;
+        private const int BusyEvery = 10;
+
+        private readonly ITestOutputHelper output;
+        private readonly List<object> plugins = new List<object>();
+
+        public CompositeHookBenchmark(ITestOutputHelper output)
+        {
+            this.output = output;
+            for (var i = 0; i < PluginCount; i++)
+                plugins.Add(i % BusyEvery == 0 ? new BusyPlugin($"busy{i}") : (object)new IdlePlugin($"idle{i}"));
+            plugins.Add(new object()); // doesn't implement the interface at all
+        }
+
+        private static string GetName(object plugin) => ((IFramePlugin)plugin).Name;
+
+        [Fact]
+        public void OnlyBindsNonEmptyHooks()
+        {
+            var update = CompositeHook<Action>.Create(plugins, GetName, typeof(IFramePlugin), nameof(IFramePlugin.OnUpdate));
+            var loaded = CompositeHook<Action<int>>.Create(plugins, GetName, typeof(IFramePlugin), nameof(IFramePlugin.OnLevelWasLoaded));
+
+            var busy = plugins.OfType<BusyPlugin>().ToList();
+            Assert.Equal(busy.Count, update.Delegates.Length);
+            Assert.Equal(busy.Select(p => p.Name), update.Names);
+
+            update.Invoke();
+            loaded.Invoke(3);
+            Assert.All(busy, p => Assert.Equal(1, p.Updates));
+            Assert.All(busy, p => Assert.Equal(3, p.LastLevel));
+        }
+
+        [Fact]
+        public void PerFrameDispatch()
+        {
+            const int frames = 20000;
+            var update = CompositeHook<Action>.Create(plugins, GetName, typeof(IFramePlugin), nameof(IFramePlugin.OnUpdate));
+
+            // how every plugin was called each frame before the hooks were prebuilt
+            var byInterface = Benchmark.Report(output, $"interface, {PluginCount} plugins", frames, _ =>
+            {
+                foreach (var plugin in plugins)
+                {
+                    try
+                    {
+                        if (plugin is IFramePlugin p)
+                            p.OnUpdate();
+                    }
+                    catch (Exception e)
+                    {
+                        output.WriteLine(e.ToString());
+                    }
+                }
+            });
+            var hooked = Benchmark.Report(output, $"hook, {update.Delegates.Length} bound", frames, _ => update.Invoke());
+            output.WriteLine("the hook is {0:F1}x faster", (double)byInterface.Ticks / hooked.Ticks);
+
+            // both ran every busy plugin once per frame, plus once each to warm up
+            Assert.All(plugins.OfType<BusyPlugin>(), p => Assert.Equal(2 * (frames + 1), p.Updates));
+        }
+    }
+}
@@ -0,0 +1,131 @@
+﻿using System;
+using System.Diagnostics;
+using System.IO;
+using System.Threading;
+using IPA.Config;
+using IPA.Config.Data;
+using IPA.Config.Providers;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace IPA.Tests
+{
+    /// <summary>
+    /// Many threads changing one config as fast as they can, to see how many of those changes reach the disk.
+    /// </summary>
+    public class ConfigSaveStressTest : IDisposable
+    {
+        private const int Threads = 8;
+        private const int SaveDelayMs = 50;
+        private static readonly TimeSpan StressTime = TimeSpan.FromSeconds(2);
+
+        private readonly ITestOutputHelper output;
+        private readonly DirectoryInfo dir = new DirectoryInfo(Path.Combine(Path.GetTempPath(), "IPA.Tests-" + Guid.NewGuid().ToString("N")));
+        private readonly int oldSaveDelay;
+
+        public ConfigSaveStressTest(ITestOutputHelper output)
+        {
+            this.output = output;
+            dir.Create();
+            oldSaveDelay = SelfConfig.Instance.ConfigSaveDelay;
+            SelfConfig.Instance.ConfigSaveDelay = SaveDelayMs;
+        }
+
+        public void Dispose()
+        {
+            SelfConfig.Instance.ConfigSaveDelay = oldSaveDelay;
+            dir.Delete(true);
+        }
+
+        private sealed class CountingProvider : IConfigProvider
+        {
+            private readonly JsonConfigProvider inner = new JsonConfigProvider();
+            public int Writes;
+            public long BytesWritten;
+
+            public string Extension => "json";
+
+            public void Store(Value value, FileInfo file)
+            {
+                inner.Store(value, file);
+                file.Refresh();
+                _ = Interlocked.Increment(ref Writes);
+                _ = Interlocked.Add(ref BytesWritten, file.Length);
+            }
+
+            public Value Load(FileInfo file) => inner.Load(file);
+        }
+
+        private sealed class CountingStore : IConfigStore
+        {
+            public long Changes;
+
+            public WaitHandle SyncObject => null;
+            public ReaderWriterLockSlim WriteSyncObject { get; } = new ReaderWriterLockSlim(LockRecursionPolicy.SupportsRecursion);
+
+            public void WriteTo(ConfigProvider provider)
+            {
+                var map = Value.Map();
+                map.Add("Changes", Value.Integer(Interlocked.Read(ref Changes)));
+                for (var i = 0; i < 100; i++)
+                    map.Add("Padding" + i, Value.Text("a config of a more typical size"));
+                provider.Store(map);
+            }
+
+            public void ReadFrom(ConfigProvider provider) { }
+        }
+
+        [Fact]
+        public void WritesPerChange()
+        {
+            var provider = new CountingProvider();
+            var file = new FileInfo(Path.Combine(dir.FullName, "Stress.json"));
+            var config = new Config.Config("Stress", provider, file);
+            ConfigRuntime.RegisterConfig(config);
+            var store = new CountingStore();
+            config.SetStore(store);
+
+            var stop = Stopwatch.StartNew();
+            var threads = new Thread[Threads];
+            for (var t = 0; t < Threads; t++)
+            {
+                threads[t] = new Thread(() =>
+                {
+                    while (stop.Elapsed < StressTime)
+                    {
+                        // what a generated store does when a property is set
+                        _ = Interlocked.Increment(ref store.Changes);
+                        ConfigRuntime.AddRequiresSave(store);
+                    }
+                });
+                threads[t].Start();
+            }
+            foreach (var thread in threads)
+                thread.Join();
+
+            // the last change must still be saved once things settle
+            var expected = Interlocked.Read(ref store.Changes);
+            var deadline = Stopwatch.StartNew();
+            int writes;
+            do
+            {
+                writes = Volatile.Read(ref provider.Writes);
+                Thread.Sleep(SaveDelayMs * 2);
+            }
+            while ((Volatile.Read(ref config.SavePending) != 0 || writes != Volatile.Read(ref provider.Writes))
+                && deadline.ElapsedMilliseconds < SaveDelayMs * ConfigRuntime.MaxSaveDelayFactor * 4);
+
+            var saved = Assert.IsType<Map>(provider.Load(file));
+            Assert.Equal(expected, Assert.IsType<Integer>(saved["Changes"]).Value);
+            Assert.False(File.Exists(file.FullName + ".tmp"));
+
+            output.WriteLine("{0:N0} changes from {1} threads over {2:F1} s", expected, Threads, StressTime.TotalSeconds);
+            output.WriteLine("{0:N0} writes, {1:F1} KB written; a write per change would have been {2:F1} MB",
+                provider.Writes, provider.BytesWritten / 1024.0, expected * (double)file.Length / (1024 * 1024));
+
+            // changes never stop here, so only the upper bound on the delay keeps saves coming
+            var maxWrites = StressTime.TotalMilliseconds / (SaveDelayMs * ConfigRuntime.MaxSaveDelayFactor) + 2;
+            Assert.InRange(provider.Writes, 1, (int)maxWrites * 2);
+        }
+    }
+}
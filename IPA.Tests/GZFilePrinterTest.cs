@@ -0,0 +1,150 @@
+﻿using System;
+using System.Diagnostics;
+using System.IO;
+using System.Threading;
+using IPA.Logging;
+using IPA.Logging.Printers;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace IPA.Tests
+{
+    public class GZFilePrinterTest : IDisposable
+    {
+        private readonly ITestOutputHelper output;
+        private readonly DirectoryInfo dir = new DirectoryInfo(Path.Combine(Path.GetTempPath(), "IPA.Tests-" + Guid.NewGuid().ToString("N")));
+
+        public GZFilePrinterTest(ITestOutputHelper output)
+        {
+            this.output = output;
+            dir.Create();
+        }
+
+        public void Dispose()
+        {
+            GZFilePrinter.CloseAll();
+            dir.Delete(true);
+        }
+
+        private sealed class TestPrinter : GZFilePrinter
+        {
+            private readonly FileInfo file;
+            private readonly TimeSpan flushInterval;
+
+            public TestPrinter(FileInfo file, TimeSpan flushInterval)
+            {
+                this.file = file;
+                this.flushInterval = flushInterval;
+            }
+
+            public override Logger.LogLevel Filter { get; set; } = Logger.LogLevel.All;
+
+            protected override FileInfo GetFileInfo() => file;
+
+            protected override TimeSpan FlushInterval => flushInterval;
+
+            public FileInfo Written => new FileInfo(file.FullName + ".gz");
+
+            public override void Print(Logger.Level level, DateTime time, string logName, string message)
+                => FileWriter.WriteLine("[{3} @ {2:HH:mm:ss} | {1}] {0}", message, logName, time, level);
+        }
+
+        private static LogMessage[] Messages(int count, int offset = 0)
+        {
+            var messages = new LogMessage[count];
+            var time = new DateTime(2020, 1, 1);
+            for (var i = 0; i < count; i++)
+            {
+                var n = offset + i;
+                messages[i] = new LogMessage(Logger.Level.Info, time.AddMilliseconds(n), null, "Plugin" + n % 7,
+                    $"Loaded item {n} of the set in {n % 100} ms", null);
+            }
+            return messages;
+        }
+
+        private static void PrintSession(GZFilePrinter printer, ArraySegment<LogMessage> messages)
+        {
+            printer.StartPrint();
+            printer.Print(messages);
+            printer.EndPrint();
+        }
+
+        private static void AssertOpenOneHour(TimeSpan untilIdle)
+            => Assert.True(untilIdle > TimeSpan.Zero && untilIdle <= TimeSpan.FromHours(1));
+
+        [Fact]
+        public void ClosesIdleFilesAndAppendsToThemLater()
+        {
+            var printer = new TestPrinter(new FileInfo(Path.Combine(dir.FullName, "idle.log")), TimeSpan.FromHours(1));
+            PrintSession(printer, new ArraySegment<LogMessage>(Messages(10)));
+            AssertOpenOneHour(GZFilePrinter.CloseIdle());
+            Assert.Throws<IOException>(() => printer.Written.Open(FileMode.Open, FileAccess.Read, FileShare.None).Dispose());
+
+            var idle = new TestPrinter(new FileInfo(Path.Combine(dir.FullName, "idle2.log")), TimeSpan.Zero);
+            PrintSession(idle, new ArraySegment<LogMessage>(Messages(10)));
+            AssertOpenOneHour(GZFilePrinter.CloseIdle());
+
+            // the file is closed, with a complete member
+            var length = idle.Written.Length;
+            idle.Written.Open(FileMode.Open, FileAccess.Read, FileShare.None).Dispose();
+
+            // and printing again appends a new member
+            PrintSession(idle, new ArraySegment<LogMessage>(Messages(10, 10)));
+            AssertOpenOneHour(GZFilePrinter.CloseIdle());
+            Assert.True(idle.Written.Length > length);
+
+            printer.Dispose();
+            Assert.Equal(Timeout.InfiniteTimeSpan, GZFilePrinter.CloseIdle());
+        }
+
+        [Fact]
+        public void BytesAndCpuPerMillionLines()
+        {
+            const int lines = 250000;
+            const int perMillion = 1000000 / lines;
+            var messages = Messages(lines);
+
+            void Measure(string name, Func<long> write)
+            {
+                var cpu = Process.GetCurrentProcess().TotalProcessorTime;
+                var sw = Stopwatch.StartNew();
+                var bytes = write();
+                sw.Stop();
+                cpu = Process.GetCurrentProcess().TotalProcessorTime - cpu;
+                output.WriteLine("{0,-32} {1,8:F1} MB  {2,8:F0} ms CPU  {3,8:F0} ms  per million lines",
+                    name, bytes * perMillion / 1e6, cpu.TotalMilliseconds * perMillion, sw.Elapsed.TotalMilliseconds * perMillion);
+            }
+
+            Measure("uncompressed", () =>
+            {
+                var file = new FileInfo(Path.Combine(dir.FullName, "plain.log"));
+                using (var writer = new StreamWriter(file.FullName))
+                {
+                    foreach (var msg in messages)
+                        writer.WriteLine("[{3} @ {2:HH:mm:ss} | {1}] {0}", msg.Message, msg.LogName, msg.Time, msg.Level);
+                }
+                return new FileInfo(file.FullName).Length;
+            });
+
+            // sessions of 256 messages, the log thread's batch size, either continuing one member, or closing the file
+            // after each one, as happens when the log goes idle between them
+            foreach (var closeEach in new[] { false, true })
+            {
+                Measure(closeEach ? "gzip, member per 256 lines" : "gzip, one member", () =>
+                {
+                    var printer = new TestPrinter(new FileInfo(Path.Combine(dir.FullName, $"gz{closeEach}.log")), TimeSpan.FromHours(1));
+                    using (printer)
+                    {
+                        for (var i = 0; i < lines; i += 256)
+                        {
+                            PrintSession(printer, new ArraySegment<LogMessage>(messages, i, Math.Min(256, lines - i)));
+                            if (closeEach)
+                                printer.Dispose();
+                        }
+                    }
+                    return printer.Written.Length;
+                });
+            }
+        }
+    }
+}
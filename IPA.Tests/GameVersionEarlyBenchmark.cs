@@ -0,0 +1,94 @@
+﻿using System;
+using System.IO;
+using System.Text;
+using IPA.Injector;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace IPA.Tests
+{
+    public class GameVersionEarlyBenchmark : IDisposable
+    {
+        private const string Key = "public.app-category.games";
+        private const string Version = "1.29.1_4575554838";
+
+        private readonly ITestOutputHelper output;
+        private readonly string path = Path.GetTempFileName();
+
+        public GameVersionEarlyBenchmark(ITestOutputHelper output)
+        {
+            this.output = output;
+        }
+
+        public void Dispose() => File.Delete(path);
+
+        // about the size of a real globalgamemanagers, with the key near the end
+        private void WriteSyntheticFile(int size, int keyAt)
+        {
+            var data = new byte[size];
+            new Random(42).NextBytes(data);
+            for (var i = 0; i < data.Length; i++)
+            { // no stray digits, so the version after the key is the first one found
+                if (data[i] >= '0' && data[i] <= '9') data[i] = 0;
+            }
+
+            var key = Encoding.UTF8.GetBytes(Key);
+            var version = Encoding.UTF8.GetBytes(Version);
+            Buffer.BlockCopy(key, 0, data, keyAt, key.Length);
+            var at = keyAt + key.Length;
+            at += 4 - at % 4; // aligned, like Unity writes it
+            Array.Clear(data, keyAt + key.Length, at - keyAt - key.Length);
+            Buffer.BlockCopy(BitConverter.GetBytes(version.Length), 0, data, at, 4);
+            Buffer.BlockCopy(version, 0, data, at + 4, version.Length);
+
+            File.WriteAllBytes(path, data);
+        }
+
+        private string Scan()
+        {
+            using (var stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read, 1, FileOptions.SequentialScan))
+            {
+                var keyEnd = GameVersionEarly.FindKey(stream, Encoding.UTF8.GetBytes(Key));
+                Assert.True(keyEnd >= 0);
+                Assert.True(GameVersionEarly.TryFindVersion(stream, keyEnd, out var version));
+                return version;
+            }
+        }
+
+        // how the file was read before it was scanned in blocks
+        private long ScanByteAtATime()
+        {
+            using (var reader = new BinaryReader(File.OpenRead(path), Encoding.UTF8))
+            {
+                var stream = reader.BaseStream;
+                var matched = 0;
+                while (stream.Position < stream.Length && matched < Key.Length)
+                    matched = reader.ReadByte() == Key[matched] ? matched + 1 : 0;
+                return stream.Position;
+            }
+        }
+
+        [Theory]
+        [InlineData(81920 - 10)] // straddles the first two blocks
+        [InlineData(2 * (81920 - 24) + 81920 - 12)] // straddles a later pair of blocks
+        [InlineData(5 * 1024 * 1024)]
+        public void FindsVersionAnywhere(int keyAt)
+        {
+            WriteSyntheticFile(keyAt + 4096, keyAt);
+            Assert.Equal(Version, Scan());
+        }
+
+        [Fact]
+        public void ScanSyntheticGlobalGameManagers()
+        {
+            WriteSyntheticFile(6 * 1024 * 1024, 6 * 1024 * 1024 - 4096);
+
+            string found = null;
+            var blocks = Benchmark.Report(output, "block scan", 20, _ => found = Scan());
+            var bytes = Benchmark.Report(output, "byte at a time", 2, _ => ScanByteAtATime());
+            output.WriteLine("block scan is {0:F1}x faster", bytes.Ticks / 2.0 / (blocks.Ticks / 20.0));
+
+            Assert.Equal(Version, found);
+        }
+    }
+}
@@ -0,0 +1,95 @@
+﻿using System;
+using System.IO;
+using System.Runtime.InteropServices;
+using System.Text;
+using IPA.Config;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace IPA.Tests
+{
+    public class IniFileTest : IDisposable
+    {
+        private readonly ITestOutputHelper output;
+        private readonly string path = Path.Combine(Path.GetTempPath(), "IPA.Tests-" + Guid.NewGuid().ToString("N") + ".ini");
+
+        public IniFileTest(ITestOutputHelper output)
+        {
+            this.output = output;
+        }
+
+        public void Dispose()
+        {
+            IniFile.FlushAll(); // so that a pending write doesn't recreate it
+            File.Delete(path);
+        }
+
+        [Fact]
+        public void SharesOneInstancePerPath()
+        {
+            var ini = IniFile.Open(path);
+            Assert.Same(ini, IniFile.Open(Path.Combine(Path.GetDirectoryName(path), ".", Path.GetFileName(path))));
+        }
+
+        [Fact]
+        public void KeepsPendingWritesOverExternalChanges()
+        {
+            File.WriteAllText(path, "[A]\r\nx=1\r\nz=3\r\n");
+            var ini = IniFile.Open(path);
+
+            ini.IniWriteValue("A", "y", "2");
+            ini.IniWriteValue("A", "z", null);
+            File.WriteAllText(path, "[A]\r\nx=external\r\nz=3\r\n");
+            ini.Reload(force: false);
+
+            Assert.Equal("external", ini.IniReadValue("A", "x"));
+            Assert.Equal("2", ini.IniReadValue("A", "y"));
+            Assert.Equal("", ini.IniReadValue("A", "z"));
+
+            ini.Flush();
+            Assert.Equal("[A]\r\nx=external\r\ny=2\r\n", File.ReadAllText(path));
+        }
+
+        [DllImport("KERNEL32.DLL", EntryPoint = "GetPrivateProfileStringW", CharSet = CharSet.Unicode, ExactSpelling = true)]
+        private static extern int GetPrivateProfileString(string section, string key, string def, StringBuilder result, int size, string file);
+
+        [DllImport("KERNEL32.DLL", EntryPoint = "WritePrivateProfileStringW", CharSet = CharSet.Unicode, ExactSpelling = true)]
+        private static extern int WritePrivateProfileString(string section, string key, string value, string file);
+
+        [Fact]
+        public void PerCallCost()
+        {
+            const int calls = 20000;
+            var sb = new StringBuilder();
+            for (var i = 0; i < 50; i++)
+                sb.Append($"[Section{i}]\r\nKey=Value\r\nOther={i}\r\n");
+            File.WriteAllText(path, sb.ToString());
+
+            var ini = IniFile.Open(path);
+            var read = Benchmark.Report(output, "read", calls, i => ini.IniReadValue("Section" + i % 50, "Other"));
+            var write = Benchmark.Report(output, "write", calls, i => ini.IniWriteValue("Section" + i % 50, "Key", "v" + i));
+            ini.Flush();
+            Assert.Equal("v" + (calls - 1), ini.IniReadValue("Section" + (calls - 1) % 50, "Key"));
+
+            if (Environment.OSVersion.Platform != PlatformID.Win32NT)
+                return; // the old implementation only exists on Windows
+
+            var oldPath = path + ".old";
+            File.WriteAllText(oldPath, sb.ToString(), Encoding.Unicode);
+            try
+            {
+                var result = new StringBuilder(1023);
+                var oldRead = Benchmark.Report(output, "read, profile API", calls, i =>
+                    GetPrivateProfileString("Section" + i % 50, "Other", "", result, 1023, oldPath));
+                var oldWrite = Benchmark.Report(output, "write, profile API", calls / 10, i =>
+                    WritePrivateProfileString("Section" + i % 50, "Key", "v" + i, oldPath));
+                output.WriteLine("reads are {0:F0}x faster, writes are {1:F0}x faster",
+                    (double)oldRead.Ticks / read.Ticks, oldWrite.Ticks * 10.0 / write.Ticks);
+            }
+            finally
+            {
+                File.Delete(oldPath);
+            }
+        }
+    }
+}
@@ -0,0 +1,171 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using IPA.Config.Data;
+using IPA.Config.Providers;
+using Newtonsoft.Json;
+using Newtonsoft.Json.Linq;
+using Xunit;
+using Xunit.Abstractions;
+using Boolean = IPA.Config.Data.Boolean;
+
+namespace IPA.Tests
+{
+    /// <summary>
+    /// Loads and stores of a large config, through <see cref="JsonConfigProvider"/> and through a copy of the
+    /// <see cref="JToken"/> round trip it used to make.
+    /// </summary>
+    public class JsonConfigProviderBenchmark : IDisposable
+    {
+        private const int Sections = 200;
+        private const int EntriesPerSection = 50;
+        private const int Iterations = 20;
+
+        private readonly ITestOutputHelper output;
+        private readonly DirectoryInfo dir = new DirectoryInfo(Path.Combine(Path.GetTempPath(), "IPA.Tests-" + Guid.NewGuid().ToString("N")));
+        private readonly JsonConfigProvider provider = new JsonConfigProvider();
+        private readonly Map config = BuildConfig();
+
+        public JsonConfigProviderBenchmark(ITestOutputHelper output)
+        {
+            this.output = output;
+            dir.Create();
+        }
+
+        public void Dispose()
+        {
+            dir.Delete(true);
+        }
+
+        // about 10k entries of every kind the provider writes, much like a big plugin's settings
+        private static Map BuildConfig()
+        {
+            var root = Value.Map();
+            for (var s = 0; s < Sections; s++)
+            {
+                var section = Value.Map();
+                for (var e = 0; e < EntriesPerSection; e++)
+                {
+                    switch (e % 5)
+                    {
+                        case 0: section.Add("Name" + e, Value.Text($"Section {s} entry {e}")); break;
+                        case 1: section.Add("Count" + e, Value.Integer(s * 1000L + e)); break;
+                        case 2: section.Add("Scale" + e, Value.Float(s + e / 8m)); break;
+                        case 3: section.Add("Enabled" + e, Value.Bool(e % 2 == 0)); break;
+                        default: section.Add("Color" + e, Value.From(new Value[] { Value.Float(0.25m), Value.Float(0.5m), Value.Float(1m), Value.Integer(e) })); break;
+                    }
+                }
+                root.Add("Section" + s, section);
+            }
+            return root;
+        }
+
+        [Fact]
+        public void LargeConfigLoadAndStore()
+        {
+            var file = new FileInfo(Path.Combine(dir.FullName, "Large.json"));
+            var domFile = new FileInfo(Path.Combine(dir.FullName, "LargeDom.json"));
+
+            provider.Store(config, file);
+            DomStore(config, domFile);
+            output.WriteLine("{0} sections x {1} entries, {2:F1} KB on disk", Sections, EntriesPerSection, file.Length / 1024.0);
+
+            // both must read back what was written
+            AssertSameValue(config, provider.Load(file));
+            AssertSameValue(config, DomLoad(domFile));
+
+            Report("stream load", () => provider.Load(file));
+            Report("JToken load", () => DomLoad(file));
+            Report("stream store", () => provider.Store(config, file));
+            Report("JToken store", () => DomStore(config, domFile));
+        }
+
+        private void Report(string name, Action body)
+        {
+            AppDomain.MonitoringIsEnabled = true;
+            var allocatedBefore = AppDomain.CurrentDomain.MonitoringTotalAllocatedMemorySize;
+            var time = Benchmark.Time(Iterations, _ => body());
+            var allocated = AppDomain.CurrentDomain.MonitoringTotalAllocatedMemorySize - allocatedBefore;
+            output.WriteLine("{0,-16} {1,8:F2} ms/op  {2,10:F1} KB allocated/op",
+                name, time.TotalMilliseconds / Iterations, allocated / 1024.0 / (Iterations + 1));
+        }
+
+        // compares numbers by value, since 1 is written as 1.0 and comes back with a different scale
+        private static void AssertSameValue(Value expected, Value actual)
+        {
+            switch (expected)
+            {
+                case Map m:
+                    var actualMap = Assert.IsType<Map>(actual);
+                    Assert.Equal(m.Keys, actualMap.Keys);
+                    foreach (var kvp in m)
+                        AssertSameValue(kvp.Value, actualMap[kvp.Key]);
+                    break;
+                case List l:
+                    var actualList = Assert.IsType<List>(actual);
+                    Assert.Equal(l.Count, actualList.Count);
+                    for (var i = 0; i < l.Count; i++)
+                        AssertSameValue(l[i], actualList[i]);
+                    break;
+                case FloatingPoint f:
+                    Assert.Equal(f.Value, Assert.IsType<FloatingPoint>(actual).Value);
+                    break;
+                default:
+                    Assert.Equal(expected.ToString(), actual.ToString());
+                    break;
+            }
+        }
+
+        // what JsonConfigProvider did before
+        private static Value DomLoad(FileInfo file)
+        {
+            using (var sreader = new StreamReader(file.OpenRead()))
+            using (var jreader = new JsonTextReader(sreader))
+                return ToValue(JToken.ReadFrom(jreader));
+        }
+
+        private static Value ToValue(JToken tok)
+        {
+            switch (tok.Type)
+            {
+                case JTokenType.Boolean: return Value.Bool((bool)tok);
+                case JTokenType.String: return Value.Text((string)tok);
+                case JTokenType.Integer: return Value.Integer((long)tok);
+                case JTokenType.Float: return Value.Float((decimal)tok);
+                case JTokenType.Array: return Value.From(((JArray)tok).Select(ToValue));
+                case JTokenType.Object:
+                    return Value.From(((IEnumerable<KeyValuePair<string, JToken>>)tok)
+                        .Select(kvp => new KeyValuePair<string, Value>(kvp.Key, ToValue(kvp.Value))));
+                default: return Value.Null();
+            }
+        }
+
+        private static void DomStore(Value value, FileInfo file)
+        {
+            using (var swriter = new StreamWriter(file.Open(FileMode.Create, FileAccess.Write)))
+            using (var jwriter = new JsonTextWriter(swriter) { Formatting = Formatting.Indented })
+                ToToken(value).WriteTo(jwriter);
+        }
+
+        private static JToken ToToken(Value val)
+        {
+            switch (val)
+            {
+                case Text t: return new JValue(t.Value);
+                case Boolean b: return new JValue(b.Value);
+                case Integer i: return new JValue(i.Value);
+                case FloatingPoint f: return new JValue(f.Value);
+                case List l:
+                    var jarr = new JArray();
+                    foreach (var item in l) jarr.Add(ToToken(item));
+                    return jarr;
+                case Map m:
+                    var jobj = new JObject();
+                    foreach (var kvp in m) jobj.Add(kvp.Key, ToToken(kvp.Value));
+                    return jobj;
+                default: return JValue.CreateNull();
+            }
+        }
+    }
+}
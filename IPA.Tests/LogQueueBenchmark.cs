@@ -0,0 +1,123 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Diagnostics;
+using System.Threading;
+using IPA.Utilities.Async;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace IPA.Tests
+{
+    /// <summary>
+    /// Many threads logging at once, through the queue between them and the log thread. This drives the queue the way
+    /// <see cref="Logging.StandardLogger"/> does, since a real logger's thread takes over the console on its first message.
+    /// </summary>
+    public class LogQueueBenchmark
+    {
+        private const int TotalMessages = 400000;
+        private const int QueueCapacity = 4096; // the same as the log queue
+        private const int BatchSize = 256;
+
+        private readonly ITestOutputHelper output;
+
+        public LogQueueBenchmark(ITestOutputHelper output)
+        {
+            this.output = output;
+        }
+
+        private struct Message
+        {
+            public int Producer;
+            public int Sequence;
+            public long Enqueued;
+        }
+
+        private sealed class Consumer
+        {
+            private readonly int[] nextSequence;
+            public readonly long[] Latencies = new long[TotalMessages];
+            public int Received;
+            public int OutOfOrder;
+
+            public Consumer(int producers) => nextSequence = new int[producers];
+
+            public void Process(in Message message)
+            {
+                Latencies[Received++] = Stopwatch.GetTimestamp() - message.Enqueued;
+                // each thread's messages must stay in order; counted here, since a throw would take down the consumer thread
+                if (nextSequence[message.Producer]++ != message.Sequence)
+                    OutOfOrder++;
+            }
+        }
+
+        private void Run(string name, int producers, Action<Message> enqueue, Action complete, Action<Consumer> consume)
+        {
+            var consumer = new Consumer(producers);
+            var consumerThread = new Thread(() => consume(consumer));
+            var perProducer = TotalMessages / producers;
+            var start = new ManualResetEventSlim();
+            var threads = new Thread[producers];
+            for (var p = 0; p < producers; p++)
+            {
+                var producer = p;
+                threads[p] = new Thread(() =>
+                {
+                    start.Wait();
+                    for (var i = 0; i < perProducer; i++)
+                        enqueue(new Message { Producer = producer, Sequence = i, Enqueued = Stopwatch.GetTimestamp() });
+                });
+                threads[p].Start();
+            }
+            consumerThread.Start();
+
+            GC.Collect();
+            var sw = Stopwatch.StartNew();
+            start.Set();
+            foreach (var thread in threads)
+                thread.Join();
+            complete();
+            consumerThread.Join();
+            sw.Stop();
+
+            Assert.Equal(perProducer * producers, consumer.Received);
+            Assert.Equal(0, consumer.OutOfOrder);
+            var latencies = new long[consumer.Received];
+            Array.Copy(consumer.Latencies, latencies, latencies.Length);
+            Array.Sort(latencies);
+            double Micros(long ticks) => ticks * 1e6 / Stopwatch.Frequency;
+            output.WriteLine("{0,-20} {1,2} threads  {2,8:F2} M msg/s  latency p50 {3,8:F1} us  p99 {4,8:F1} us  max {5,9:F1} us",
+                name, producers, consumer.Received / sw.Elapsed.TotalSeconds / 1e6,
+                Micros(latencies[latencies.Length / 2]), Micros(latencies[latencies.Length * 99 / 100]), Micros(latencies[latencies.Length - 1]));
+        }
+
+        [Theory]
+        [InlineData(1)]
+        [InlineData(4)]
+        [InlineData(8)]
+        public void ThroughputAndLatency(int producers)
+        {
+            var ring = new BoundedMpscQueue<Message>(QueueCapacity);
+            Run("bounded ring", producers, m => ring.Enqueue(in m), ring.CompleteAdding, consumer =>
+            {
+                var batch = new Message[BatchSize];
+                while (ring.WaitForItems(Timeout.Infinite))
+                {
+                    int count;
+                    while ((count = ring.DequeueBatch(batch)) > 0)
+                    {
+                        for (var i = 0; i < count; i++)
+                            consumer.Process(in batch[i]);
+                    }
+                }
+            });
+
+            // what the log queue was before
+            var collection = new BlockingCollection<Message>();
+            Run("BlockingCollection", producers, collection.Add, collection.CompleteAdding, consumer =>
+            {
+                foreach (var message in collection.GetConsumingEnumerable())
+                    consumer.Process(in message);
+            });
+        }
+    }
+}
@@ -0,0 +1,77 @@
+﻿using System.Threading.Tasks;
+using IPA.Loader;
+using Xunit;
+
+namespace IPA.Tests
+{
+    public class PendingTransitionsTest
+    {
+        [Fact]
+        public void BlocksPluginsUntilTheirTaskCompletes()
+        {
+            var pending = new PendingTransitions();
+            var a = new PluginMetadata();
+            var b = new PluginMetadata();
+
+            // a has an asynchronous enable, b enabled synchronously
+            var enableA = new TaskCompletionSource<object>();
+            pending.Track(a, enableA.Task);
+            pending.Track(b, Task.CompletedTask);
+
+            Assert.Same(a, pending.FirstPending(new[] { b, a }));
+            Assert.Null(pending.FirstPending(new[] { b }));
+
+            enableA.SetResult(null);
+            Assert.Null(pending.FirstPending(new[] { a, b }));
+            Assert.Equal(0, pending.Count);
+        }
+
+        [Fact]
+        public void TogglingRepeatedly()
+        {
+            var pending = new PendingTransitions();
+            var plugins = new PluginMetadata[8];
+            for (var i = 0; i < plugins.Length; i++)
+                plugins[i] = new PluginMetadata();
+
+            // each round toggles every plugin, with half of them finishing asynchronously, and tries to toggle them all
+            // again before those finish, which must be refused for exactly the unfinished ones
+            for (var round = 0; round < 100; round++)
+            {
+                var sources = new TaskCompletionSource<object>[plugins.Length];
+                for (var i = 0; i < plugins.Length; i++)
+                {
+                    Assert.Null(pending.FirstPending(new[] { plugins[i] }));
+
+                    sources[i] = new TaskCompletionSource<object>();
+                    if ((i + round) % 2 == 0)
+                        sources[i].SetResult(null);
+                    pending.Track(plugins[i], sources[i].Task);
+                }
+
+                for (var i = 0; i < plugins.Length; i++)
+                {
+                    var isAsync = (i + round) % 2 != 0;
+                    Assert.Equal(isAsync ? plugins[i] : null, pending.FirstPending(new[] { plugins[i] }));
+                }
+                Assert.Equal(plugins.Length / 2, pending.Count);
+
+                foreach (var source in sources)
+                    source.TrySetResult(null);
+                Assert.Equal(0, pending.Count);
+            }
+        }
+
+        [Fact]
+        public void FaultedTasksStillComplete()
+        {
+            var pending = new PendingTransitions();
+            var a = new PluginMetadata();
+            var disableA = new TaskCompletionSource<object>();
+            pending.Track(a, disableA.Task);
+
+            disableA.SetException(new System.InvalidOperationException("could not disable"));
+            Assert.Null(pending.FirstPending(new[] { a }));
+        }
+    }
+}
@@ -0,0 +1,110 @@
+﻿using System;
+using System.IO;
+using System.Linq;
+using System.Text.RegularExpressions;
+using System.Threading;
+using IPA.Loader;
+using Xunit;
+using Xunit.Abstractions;
+using Phase = IPA.Loader.PluginProfiler.Phase;
+
+namespace IPA.Tests
+{
+    [Collection("Plugin state")]
+    public class PluginProfilerTest : IDisposable
+    {
+        private readonly ITestOutputHelper output;
+
+        public PluginProfilerTest(ITestOutputHelper output)
+        {
+            this.output = output;
+            PluginProfiler.Reset();
+        }
+
+        public void Dispose() => PluginProfiler.Reset();
+
+        private static PluginMetadata Plugin(string name)
+            => new PluginMetadata { Manifest = new PluginManifest { Name = name, Id = name } };
+
+        private static void Spend(PluginMetadata plugin, Phase phase, int milliseconds)
+        {
+            using (PluginProfiler.Measure(plugin, phase))
+                Thread.Sleep(milliseconds);
+        }
+
+        [Fact]
+        public void ReportListsTheSlowestPluginsFirst()
+        {
+            var slow = Plugin("Slow");
+            var medium = Plugin("Medium");
+            var fast = Plugin("Fast");
+            Spend(fast, Phase.Init, 0);
+            Spend(medium, Phase.Enable, 10);
+            Spend(medium, Phase.Enable, 10);
+            Spend(slow, Phase.Init, 60);
+            Spend(slow, Phase.AssemblyLoad, 0);
+
+            var report = PluginProfiler.GetReport(2);
+            output.WriteLine(report);
+
+            var lines = report.Split(new[] { Environment.NewLine }, StringSplitOptions.None);
+            Assert.StartsWith("Plugin lifecycle profile (wall time", lines[0]);
+            Assert.StartsWith("  Slow: ", lines[1]);
+            // phases are listed in lifecycle order
+            Assert.StartsWith("    AssemblyLoad: ", lines[2]);
+            Assert.StartsWith("    Init: ", lines[3]);
+            Assert.StartsWith("  Medium: ", lines[4]);
+            Assert.Matches(@"^    Enable: \d+\.\dms \(2 times\)$", lines[5]);
+            Assert.Equal("  ... and 1 more", lines[6]);
+            Assert.Equal(7, lines.Length);
+
+            Assert.Contains("  Fast: ", PluginProfiler.GetReport());
+        }
+
+        [Fact]
+        public void ReportNamesPluginsWithoutManifestsByFile()
+        {
+            var broken = new PluginMetadata { File = new FileInfo(Path.Combine(Path.GetTempPath(), "Broken.dll")) };
+            Spend(broken, Phase.MetadataScan, 0);
+
+            Assert.Equal("Broken.dll", PluginProfiler.Samples.Single().PluginName);
+            Assert.Contains("  Broken.dll: ", PluginProfiler.GetReport());
+        }
+
+        [Fact]
+        public void TraceHasOneCompleteEventPerSample()
+        {
+            var plugin = Plugin("Traced");
+            Spend(plugin, Phase.Init, 5);
+            Spend(plugin, Phase.Enable, 0);
+
+            var writer = new StringWriter();
+            PluginProfiler.WriteChromeTrace(writer);
+            var trace = writer.ToString();
+            output.WriteLine(trace);
+
+            Assert.StartsWith("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", trace);
+            Assert.EndsWith("]}", trace);
+            Assert.Equal(2, Regex.Matches(trace, "\"ph\":\"X\"").Count);
+            Assert.Contains("\"name\":\"Traced\",\"cat\":\"Init\"", trace);
+            Assert.Contains("\"name\":\"Traced\",\"cat\":\"Enable\"", trace);
+            Assert.Contains($"\"tid\":{Thread.CurrentThread.ManagedThreadId}", trace);
+
+            // the events are in the order they finished, and the second starts after the first
+            var starts = Regex.Matches(trace, "\"ts\":([0-9.]+)").Cast<Match>()
+                .Select(m => double.Parse(m.Groups[1].Value, System.Globalization.CultureInfo.InvariantCulture)).ToArray();
+            Assert.Equal(2, starts.Length);
+            Assert.True(starts[1] >= starts[0] + 5000 * 0.9); // microseconds
+        }
+
+        [Fact]
+        public void MeasureOverhead()
+        {
+            var plugin = Plugin("Overhead");
+            Benchmark.Report(output, "empty measured scope", 100000, i =>
+            {
+                using (PluginProfiler.Measure(plugin, Phase.Enable)) { }
+            });
+        }
+    }
+}
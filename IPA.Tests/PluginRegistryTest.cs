@@ -0,0 +1,103 @@
+﻿using IPA.Loader;
+using Xunit;
+
+namespace IPA.Tests
+{
+    [Collection("Plugin state")]
+    public class PluginRegistryTest
+    {
+        private static PluginMetadata Plugin(string name, string id, params PluginMetadata[] dependencies)
+        {
+            var meta = new PluginMetadata { Manifest = new PluginManifest { Name = name, Id = id } };
+            foreach (var dep in dependencies)
+                meta.Dependencies.Add(dep);
+            return meta;
+        }
+
+        private static PluginExecutor Executor(PluginMetadata meta)
+            => new PluginExecutor(meta, PluginExecutor.Special.Bare);
+
+        [Fact]
+        public void LookupsFindTheFirstInLoadOrder()
+        {
+            var first = Plugin("A", "a");
+            var sameName = Plugin("A", "other");
+            var sameId = Plugin("Other", "a");
+            var disabled = Plugin("D", "d");
+            var disabledAgain = Plugin("D", "d");
+
+            var state = PluginRegistry.Publish(new[] { Executor(first), Executor(sameName), Executor(sameId) },
+                new[] { disabled, disabledAgain });
+
+            Assert.Same(first, state.GetEnabledByName("A"));
+            Assert.Same(first, state.GetEnabledById("a"));
+            Assert.Same(sameName, state.GetEnabledById("other"));
+            Assert.Same(sameId, state.GetEnabledByName("Other"));
+            Assert.Same(disabled, state.GetDisabledByName("D"));
+            Assert.Same(disabled, state.GetDisabledById("d"));
+            Assert.Null(state.GetEnabledByName("D"));
+            Assert.Null(state.GetDisabledById("a"));
+            Assert.Null(state.GetEnabledById(null));
+        }
+
+        [Fact]
+        public void AddLoadedKeepsLoadOrder()
+        {
+            var first = Plugin("A", "a");
+            var state = PluginRegistry.Publish(new[] { Executor(first) }, new PluginMetadata[0]);
+            var version = state.Version;
+
+            var later = Plugin("A", "a");
+            var other = Plugin("B", "b", first);
+            PluginRegistry.AddLoaded(Executor(later));
+            PluginRegistry.AddLoaded(Executor(other));
+
+            Assert.Same(state, PluginRegistry.Current);
+            Assert.Equal(version, state.Version);
+            Assert.Equal(new[] { first, later, other }, state.Enabled);
+            Assert.Same(first, state.GetEnabledByName("A"));
+            Assert.Same(other, state.GetEnabledById("b"));
+            Assert.True(state.IsEnabled(later));
+            Assert.True(state.TryGetExecutor(other, out var executor));
+            Assert.Same(other, executor.Metadata);
+            Assert.Equal(new[] { other }, state.GetDependents(first));
+        }
+
+        [Fact]
+        public void HasSameStateComparesMembership()
+        {
+            var a = Plugin("A", "a");
+            var b = Plugin("B", "b");
+            var execA = Executor(a);
+            var execB = Executor(b);
+
+            var state = PluginRegistry.Publish(new[] { execA, execB }, new PluginMetadata[0]);
+            var reordered = PluginRegistry.Publish(new[] { execB, execA }, new PluginMetadata[0]);
+            var toggled = PluginRegistry.Publish(new[] { execA }, new[] { b });
+
+            Assert.NotEqual(state.Version, reordered.Version);
+            Assert.True(state.HasSameState(state));
+            Assert.True(state.HasSameState(reordered));
+            Assert.False(state.HasSameState(toggled));
+            Assert.False(toggled.HasSameState(state));
+            Assert.True(toggled.HasSameState(PluginRegistry.Publish(new[] { execA }, new[] { b })));
+        }
+
+        [Fact]
+        public void GetDependentsCoversEnabledAndDisabledPlugins()
+        {
+            var a = Plugin("A", "a");
+            var enabledDependent = Plugin("B", "b", a);
+            var disabledDependent = Plugin("C", "c", a);
+            var transitive = Plugin("D", "d", enabledDependent);
+
+            var state = PluginRegistry.Publish(new[] { Executor(a), Executor(enabledDependent), Executor(transitive) },
+                new[] { disabledDependent });
+
+            Assert.Equal(new[] { enabledDependent, disabledDependent }, state.GetDependents(a));
+            Assert.Equal(new[] { transitive }, state.GetDependents(enabledDependent));
+            Assert.Empty(state.GetDependents(transitive));
+            Assert.Empty(state.GetDependents(disabledDependent));
+        }
+    }
+}
@@ -0,0 +1,137 @@
+﻿using System;
+using System.Collections.Generic;
+using System.IO;
+using IPA.Loader;
+using Mono.Cecil;
+using Mono.Cecil.Cil;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace IPA.Tests
+{
+    public class PluginTypeHeapTest : IDisposable
+    {
+        private const int PluginCount = 50;
+        private const int TypesPerPlugin = 200;
+        private const int MethodsPerType = 10;
+
+        private readonly ITestOutputHelper output;
+        private readonly DirectoryInfo dir = new DirectoryInfo(Path.Combine(Path.GetTempPath(), "IPA.Tests-" + Guid.NewGuid().ToString("N")));
+        private readonly List<PluginMetadata> plugins = new List<PluginMetadata>();
+
+        public PluginTypeHeapTest(ITestOutputHelper output)
+        {
+            this.output = output;
+            dir.Create();
+
+            for (var i = 0; i < PluginCount; i++)
+            {
+                var path = Path.Combine(dir.FullName, $"SyntheticPlugin{i}.dll");
+                WritePlugin(path, "SyntheticPlugin" + i);
+
+                using (var module = ModuleDefinition.ReadModule(path))
+                {
+                    plugins.Add(new PluginMetadata
+                    {
+                        File = new FileInfo(path),
+                        TypeHandle = new PluginTypeHandle(module.GetType("SyntheticPlugin" + i, "Plugin")),
+                    });
+                }
+            }
+        }
+
+        public void Dispose()
+        {
+            plugins.Clear();
+            GC.Collect();
+            GC.WaitForPendingFinalizers(); // so that the files PluginType opened are closed
+            dir.Delete(true);
+        }
+
+        // a plugin type, and enough other types and methods that the module is about the size of a typical plugin's
+        private static void WritePlugin(string path, string name)
+        {
+            var assemblyName = new AssemblyNameDefinition(name, new Version(1, 0, 0, 0));
+            using (var assembly = AssemblyDefinition.CreateAssembly(assemblyName, name + ".dll", ModuleKind.Dll))
+            {
+                var module = assembly.MainModule;
+                for (var t = 0; t < TypesPerPlugin; t++)
+                {
+                    var type = new TypeDefinition(name, t == 0 ? "Plugin" : "Type" + t,
+                        TypeAttributes.Public | TypeAttributes.Class, module.TypeSystem.Object);
+                    for (var m = 0; m < MethodsPerType; m++)
+                    {
+                        var method = new MethodDefinition("Method" + m, MethodAttributes.Public | MethodAttributes.Static, module.TypeSystem.String);
+                        var il = method.Body.GetILProcessor();
+                        il.Emit(OpCodes.Ldstr, $"{name}.{type.Name}.{method.Name} returns a string of a typical length");
+                        il.Emit(OpCodes.Ret);
+                        type.Methods.Add(method);
+                    }
+                    module.Types.Add(type);
+                }
+                assembly.Write(path);
+            }
+        }
+
+        private void Report(string name, Func<object> retain)
+        {
+            AppDomain.MonitoringIsEnabled = true;
+            GC.Collect();
+            GC.WaitForPendingFinalizers();
+            var before = GC.GetTotalMemory(true);
+            var allocatedBefore = AppDomain.CurrentDomain.MonitoringTotalAllocatedMemorySize;
+
+            var retained = retain();
+
+            var allocated = AppDomain.CurrentDomain.MonitoringTotalAllocatedMemorySize - allocatedBefore;
+            var after = GC.GetTotalMemory(true);
+            GC.KeepAlive(retained);
+            output.WriteLine("{0,-40} {1,8:F1} KB retained  {2,8:F1} KB allocated  per plugin",
+                name, (after - before) / 1024.0 / PluginCount, allocated / 1024.0 / PluginCount);
+        }
+
+        [Fact]
+        public void RetainedHeap()
+        {
+            // what discovery used to keep alive for the life of the game
+            Report("immediate modules, kept", () =>
+            {
+                var types = new List<TypeDefinition>();
+                foreach (var meta in plugins)
+                {
+                    var module = ModuleDefinition.ReadModule(new MemoryStream(File.ReadAllBytes(meta.File.FullName)),
+                        new ReaderParameters(ReadingMode.Immediate));
+                    types.Add(module.GetType(meta.TypeHandle.Namespace, meta.TypeHandle.Name));
+                }
+                return types;
+            });
+
+            // what discovery keeps now
+            Report("type handles, modules disposed", () =>
+            {
+                var handles = new List<PluginTypeHandle>();
+                foreach (var meta in plugins)
+                {
+                    using (var module = ModuleDefinition.ReadModule(meta.File.FullName))
+                        handles.Add(new PluginTypeHandle(module.GetType(meta.TypeHandle.Namespace, meta.TypeHandle.Name)));
+                }
+                return handles;
+            });
+
+#pragma warning disable CS0618 // PluginType is obsolete
+            Report("PluginType, accessed twice", () =>
+            {
+                var types = new List<TypeDefinition>();
+                foreach (var meta in plugins)
+                {
+                    var type = meta.PluginType;
+                    Assert.Same(type, meta.PluginType);
+                    Assert.Equal(meta.TypeHandle.FullName, type.FullName);
+                    types.Add(type);
+                }
+                return types;
+            });
+#pragma warning restore CS0618
+        }
+    }
+}
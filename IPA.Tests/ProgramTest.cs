@@ -4,6 +4,7 @@ using System.IO;
 using System.Linq;
 using System.Text;
 using System.Threading.Tasks;
+using IPA.Patcher;
 using Xunit;
 
 namespace IPA.Tests
@@ -35,5 +36,52 @@ namespace IPA.Tests
             var expectedPaths = expected.Select(e => new FileInfo(e)).Select(f => f.FullName).ToList();
             Assert.Equal(expectedPaths, outcome);
         }
+
+        [Fact]
+        public void InstallsIncrementally()
+        {
+            var root = Path.Combine(Path.GetTempPath(), "IPA.Tests-" + Guid.NewGuid().ToString("N"));
+            try
+            {
+                var game = Directory.CreateDirectory(Path.Combine(root, "Game"));
+                var payload = Directory.CreateDirectory(Path.Combine(root, "Payload"));
+                var fileA = Path.Combine(payload.FullName, "a.txt");
+                var fileB = Path.Combine(payload.FullName, "sub", "b.txt");
+                File.WriteAllText(fileA, "a");
+                Directory.CreateDirectory(Path.GetDirectoryName(fileB));
+                File.WriteAllText(fileB, "b");
+
+                var context = PatchContext.Create(Path.Combine(game.FullName, "Game.exe"), Path.Combine(root, "IPA"));
+                int Install(bool aggressive = false)
+                {
+                    var installer = new PayloadInstaller(context, new BackupUnit(context), aggressive);
+                    installer.AddDirectory(payload, game);
+                    return installer.Run();
+                }
+
+                Assert.Equal(2, Install());
+                Assert.Equal("b", File.ReadAllText(Path.Combine(game.FullName, "sub", "b.txt")));
+
+                // nothing changed
+                Assert.Equal(0, Install());
+
+                // touched, but with the same contents
+                File.SetLastWriteTimeUtc(fileA, DateTime.UtcNow.AddHours(1));
+                Assert.Equal(0, Install());
+
+                // actually changed
+                File.WriteAllText(fileB, "changed");
+                File.SetLastWriteTimeUtc(fileB, DateTime.UtcNow.AddHours(1));
+                Assert.Equal(1, Install());
+                Assert.Equal("changed", File.ReadAllText(Path.Combine(game.FullName, "sub", "b.txt")));
+
+                Assert.Equal(2, Install(aggressive: true));
+            }
+            finally
+            {
+                if (Directory.Exists(root))
+                    Directory.Delete(root, true);
+            }
+        }
     }
 }
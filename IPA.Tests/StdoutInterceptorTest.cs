@@ -0,0 +1,97 @@
+﻿using System.Collections.Generic;
+using System.Linq;
+using System.Threading;
+using IPA.Logging;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace IPA.Tests
+{
+    public class StdoutInterceptorTest
+    {
+        private readonly ITestOutputHelper output;
+
+        public StdoutInterceptorTest(ITestOutputHelper output)
+        {
+            this.output = output;
+        }
+
+        [Fact]
+        public void FlushLeavesOtherThreadsLinesAlone()
+        {
+            var emitted = new List<string>();
+            var interceptor = new StdoutInterceptor(emitted.Add);
+
+            var written = new ManualResetEventSlim();
+            var release = new ManualResetEventSlim();
+            var other = new Thread(() =>
+            {
+                interceptor.Write("other ");
+                written.Set();
+                release.Wait();
+                interceptor.Write("thread\n");
+            });
+            other.Start();
+            written.Wait();
+
+            var exited = new Thread(() => interceptor.Write("abandoned"));
+            exited.Start();
+            exited.Join();
+
+            interceptor.Write("partial");
+            interceptor.Flush();
+            Assert.Equal(new[] { "abandoned", "partial" }, emitted);
+
+            release.Set();
+            other.Join();
+            Assert.Equal(new[] { "abandoned", "partial", "other thread" }, emitted);
+        }
+
+        [Fact]
+        public void FlushAllThreadsTakesEveryLine()
+        {
+            var emitted = new List<string>();
+            var interceptor = new StdoutInterceptor(emitted.Add);
+
+            var written = new ManualResetEventSlim();
+            var release = new ManualResetEventSlim();
+            var other = new Thread(() =>
+            {
+                interceptor.Write("other");
+                written.Set();
+                release.Wait();
+            });
+            other.Start();
+            written.Wait();
+
+            interceptor.FlushAllThreads();
+            release.Set();
+            other.Join();
+            Assert.Equal(new[] { "other" }, emitted);
+        }
+
+        [Fact]
+        public void CharByCharAndBlockWrites()
+        {
+            const int lines = 20000;
+            const string line = "[Plugin] a typical line of console output, about this long";
+
+            var count = 0;
+            var interceptor = new StdoutInterceptor(_ => count++);
+
+            var chars = Benchmark.Report(output, "char by char", lines, i =>
+            {
+                foreach (var c in line)
+                    interceptor.Write(c);
+                interceptor.Write('\n');
+            });
+            var block = Benchmark.Report(output, "block", lines, i => interceptor.Write(line + "\n"));
+            _ = Benchmark.Report(output, "16 lines per block", lines / 16, i =>
+                interceptor.Write(string.Concat(Enumerable.Repeat(line + "\n", 16))));
+            output.WriteLine("per line, char by char takes {0:F1}x as long as a block",
+                (double)chars.Ticks / block.Ticks);
+
+            Assert.Equal(2 * lines + 2 + lines / 16 + 1, count);
+        }
+    }
+}
@@ -0,0 +1,80 @@
+﻿using System.Collections.Generic;
+using System.Linq;
+using IPA.Config.Data;
+using IPA.Config.Stores;
+using IPA.Config.Stores.Converters;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace IPA.Tests
+{
+    /// <summary>
+    /// The direct conversions generated stores use for enums and collections of simple values, against the converters
+    /// a member needed for the same result before.
+    /// </summary>
+    public class StoreConversionBenchmark
+    {
+        private const int Iterations = 200000;
+        private const int CollectionSize = 64;
+
+        public enum Mode
+        {
+            Off,
+            Low,
+            Medium,
+            High,
+            Maximum,
+        }
+
+        private readonly ITestOutputHelper output;
+
+        public StoreConversionBenchmark(ITestOutputHelper output)
+        {
+            this.output = output;
+        }
+
+        [Fact]
+        public void Enums()
+        {
+            var converter = new CaseInsensitiveEnumConverter<Mode>();
+            var boxed = (IValueConverter)converter;
+            var values = new[] { Value.Text("Off"), Value.Text("low"), Value.Text("Medium"), Value.Text("HIGH"), Value.Text("Maximum") };
+
+            foreach (var value in values)
+                Assert.Equal(converter.FromValue(value, this), GeneratedStoreImpl.DeserializeEnum<Mode>(value));
+            Assert.Equal(converter.ToValue(Mode.High, this).ToString(), GeneratedStoreImpl.SerializeEnum(Mode.High).ToString());
+
+            _ = Benchmark.Report(output, "serialize direct", Iterations, i => GeneratedStoreImpl.SerializeEnum((Mode)(i % 5)));
+            _ = Benchmark.Report(output, "serialize converter", Iterations, i => converter.ToValue((Mode)(i % 5), this));
+            _ = Benchmark.Report(output, "serialize boxed converter", Iterations, i => boxed.ToValue((Mode)(i % 5), this));
+            _ = Benchmark.Report(output, "deserialize direct", Iterations, i => GeneratedStoreImpl.DeserializeEnum<Mode>(values[i % 5]));
+            _ = Benchmark.Report(output, "deserialize converter", Iterations, i => converter.FromValue(values[i % 5], this));
+            _ = Benchmark.Report(output, "deserialize boxed converter", Iterations, i => boxed.FromValue(values[i % 5], this));
+        }
+
+        private void Collection<T>(string name, List<T> items)
+        {
+            var converter = new ListConverter<T>();
+            var serialized = converter.ToValue(items, this);
+
+            Assert.Equal(serialized.ToString(), GeneratedStoreImpl.SerializeCollection<T>(items, this).ToString());
+            Assert.Equal(items, GeneratedStoreImpl.DeserializeList<T>((List)serialized, this));
+
+            const int iterations = Iterations / CollectionSize;
+            _ = Benchmark.Report(output, $"{name} serialize direct", iterations, _ => GeneratedStoreImpl.SerializeCollection<T>(items, this));
+            _ = Benchmark.Report(output, $"{name} serialize converter", iterations, _ => converter.ToValue(items, this));
+            _ = Benchmark.Report(output, $"{name} deserialize direct", iterations, _ => GeneratedStoreImpl.DeserializeList<T>((List)serialized, this));
+            _ = Benchmark.Report(output, $"{name} deserialize converter", iterations, _ => converter.FromValue(serialized, this));
+        }
+
+        [Fact]
+        public void Collections()
+        {
+            var range = Enumerable.Range(0, CollectionSize);
+            Collection("int", range.ToList());
+            Collection("float", range.Select(i => i / 4f).ToList());
+            Collection("string", range.Select(i => "item " + i).ToList());
+            Collection("enum", range.Select(i => (Mode)(i % 5)).ToList());
+        }
+    }
+}
@@ -0,0 +1,105 @@
+﻿using System;
+using System.Collections.Generic;
+using IPA.Utilities.Async;
+using Xunit;
+using Priority = IPA.Utilities.Async.UnityMainThreadTaskScheduler.Priority;
+
+namespace IPA.Tests
+{
+    public class UnityMainThreadTaskSchedulerTest
+    {
+        [Fact]
+        public void DrainsLanesInPriorityOrder()
+        {
+            var sched = new UnityMainThreadTaskScheduler();
+            var order = new List<string>();
+            sched.QueueAction(() => order.Add("low"), Priority.Low);
+            sched.QueueAction(() => order.Add("normal"), Priority.Normal);
+            sched.QueueAction(() => order.Add("high"), Priority.High);
+            Assert.Equal(3, sched.Backlog);
+
+            var coro = sched.Coroutine();
+            Assert.True(coro.MoveNext()); // the first resume only starts the scheduler
+            Assert.Empty(order);
+
+            Assert.True(coro.MoveNext());
+            Assert.Equal(new[] { "high", "normal", "low" }, order);
+
+            var stats = sched.LastFrameStats;
+            Assert.Equal(3, stats.TasksRun);
+            Assert.Equal(0, stats.Backlog);
+            Assert.Equal(sched.YieldAfterTime, stats.Budget);
+            Assert.True(stats.TimeUsed >= TimeSpan.Zero);
+
+            sched.Cancel();
+            Assert.False(coro.MoveNext());
+            Assert.False(sched.IsRunning);
+        }
+
+        [Fact]
+        public void HigherLaneOvertakesBacklog()
+        {
+            var sched = new UnityMainThreadTaskScheduler { YieldAfterTasks = 2 };
+            var order = new List<int>();
+            for (var i = 0; i < 5; i++)
+            {
+                var n = i;
+                sched.QueueAction(() => order.Add(n), Priority.Low);
+            }
+
+            var coro = sched.Coroutine();
+            Assert.True(coro.MoveNext());
+            Assert.True(coro.MoveNext());
+            Assert.Equal(new[] { 0, 1 }, order);
+            Assert.Equal(2, sched.LastFrameStats.TasksRun);
+            Assert.Equal(3, sched.LastFrameStats.Backlog);
+
+            sched.QueueAction(() => order.Add(-1), Priority.High);
+            Assert.True(coro.MoveNext());
+            Assert.Equal(new[] { 0, 1, -1, 2 }, order);
+            Assert.Equal(2, sched.LastFrameStats.Backlog);
+
+            Assert.True(coro.MoveNext());
+            Assert.Equal(new[] { 0, 1, -1, 2, 3, 4 }, order);
+            Assert.Equal(2, sched.LastFrameStats.TasksRun);
+            Assert.Equal(0, sched.LastFrameStats.Backlog);
+
+            Assert.True(coro.MoveNext());
+            Assert.Equal(0, sched.LastFrameStats.TasksRun);
+
+            sched.Cancel();
+            Assert.False(coro.MoveNext());
+        }
+
+        [Fact]
+        public void AdaptiveBudgetRunsAtLeastOneItem()
+        {
+            var sched = new UnityMainThreadTaskScheduler
+            {
+                AdaptiveBudget = true,
+                MinimumBudget = TimeSpan.FromTicks(1),
+                MaximumBudget = TimeSpan.FromTicks(1),
+            };
+            var run = 0;
+            for (var i = 0; i < 3; i++)
+                sched.QueueAction(() => run++);
+
+            var coro = sched.Coroutine();
+            Assert.True(coro.MoveNext());
+            Assert.True(coro.MoveNext());
+            Assert.Equal(sched.MinimumBudget, sched.LastFrameStats.Budget); // nothing measured yet
+            Assert.True(run >= 1);
+
+            while (run < 3)
+            {
+                Assert.True(coro.MoveNext());
+                Assert.True(sched.LastFrameStats.TasksRun >= 1);
+                Assert.Equal(TimeSpan.FromTicks(1), sched.LastFrameStats.Budget);
+            }
+            Assert.Equal(0, sched.Backlog);
+
+            sched.Cancel();
+            Assert.False(coro.MoveNext());
+        }
+    }
+}
@@ -32,13 +32,16 @@ namespace IPA
 #pragma warning restore CS8618 // Non-nullable field must contain a non-null value when exiting constructor. Consider declaring as nullable.
 
         public static PatchContext Create(string exe)
+            => Create(exe, Path.Combine(Path.GetDirectoryName(Assembly.GetEntryAssembly()!.Location) ?? throw new InvalidOperationException(), "IPA"));
+
+        internal static PatchContext Create(string exe, string ipaRoot)
         {
             var context = new PatchContext
             {
                 Executable = exe
             };
             context.ProjectRoot = new FileInfo(context.Executable).Directory?.FullName ?? throw new Exception();
-            context.IPARoot = Path.Combine(Path.GetDirectoryName(Assembly.GetEntryAssembly()!.Location) ?? throw new InvalidOperationException(), "IPA");
+            context.IPARoot = ipaRoot;
             context.IPA = Assembly.GetExecutingAssembly().Location;
             context.DataPathSrc = Path.Combine(context.IPARoot, "Data");
             context.LibsPathSrc = Path.Combine(context.IPARoot, "Libs");
@@ -1,4 +1,5 @@
 ﻿using System;
+using System.Collections.Generic;
 using System.IO;
 using System.Linq;
 
@@ -11,6 +12,7 @@ namespace IPA.Patcher
             new DirectoryInfo(context.BackupPath).Create();
             return new DirectoryInfo(context.BackupPath)
                 .GetDirectories()
+                .Where(p => p.Name != BackupUnit.ObjectsDirName)
                 .OrderByDescending(p => p.Name)
                 .Select(p => BackupUnit.FromDirectory(p, context))
                 .FirstOrDefault();
@@ -28,12 +30,41 @@ namespace IPA.Patcher
             {
                 backup.Restore();
                 backup.Delete();
+                PruneObjects(context);
                 DeleteEmptyDirs(context.ProjectRoot);
                 return true;
             }
             return false;
         }
 
+        /// <summary>
+        /// Deletes every stored object that no remaining backup refers to.
+        /// </summary>
+        public static void PruneObjects(PatchContext context)
+        {
+            var objectsDir = new DirectoryInfo(Path.Combine(context.BackupPath, BackupUnit.ObjectsDirName));
+            if (!objectsDir.Exists) return;
+
+            var referenced = new HashSet<string>(new DirectoryInfo(context.BackupPath)
+                .GetDirectories()
+                .Where(p => p.Name != BackupUnit.ObjectsDirName)
+                .Select(p => BackupUnit.FromDirectory(p, context))
+                .SelectMany(u => u.ReferencedObjects));
+
+            foreach (var file in objectsDir.GetFiles("*", SearchOption.AllDirectories))
+            {
+                if (referenced.Contains(file.Name)) continue;
+                try
+                {
+                    file.Delete();
+                }
+                catch (IOException) { }
+                catch (UnauthorizedAccessException) { }
+            }
+
+            DeleteEmptyDirs(objectsDir.FullName);
+        }
+
         public static void DeleteEmptyDirs(string dir)
         {
             if (string.IsNullOrEmpty(dir))
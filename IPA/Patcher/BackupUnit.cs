@@ -1,40 +1,77 @@
 ﻿using System;
 using System.Collections.Generic;
 using System.IO;
+using System.Linq;
+using System.Security.Cryptography;
+using System.Threading.Tasks;
 
 namespace IPA.Patcher
 {
     /// <summary>
     /// A unit for backup. WIP.
     /// </summary>
+    /// <remarks>
+    /// <para>
+    /// The contents of backed up files are stored once each in a shared object store, keyed by their SHA-256, so
+    /// the same game file backed up by many installs only takes up space once. Each unit has an index that maps
+    /// the files it changed to the hash of their original contents, or to <c>-</c> if they didn't exist.
+    /// </para>
+    /// <para>
+    /// Units made before the object store hold full copies of their files instead, and are still restored from those.
+    /// New units also list the files that didn't exist in the old <c>$manifest$.txt</c>, so that installers from before
+    /// the object store, which only understand that, still delete them when reverting.
+    /// </para>
+    /// </remarks>
     public class BackupUnit
     {
         private string Name { get; }
-        
+
         private readonly DirectoryInfo _backupPath;
         private readonly PatchContext _context;
         private readonly List<string> _files = new();
+        private readonly Dictionary<string, string> _hashes = new(); // for units with an index
+        private readonly object _lock = new();
+        private readonly bool _isLegacy;
         private readonly FileInfo _manifestFile;
+        private readonly FileInfo _indexFile;
         private static readonly string _ManifestFileName = "$manifest$.txt";
-        
-        public BackupUnit(PatchContext context) : this(context, DateTime.Now.ToString("yyyy-MM-dd_h-mm-ss"))
+        internal const string IndexFileName = "$index$.txt";
+        internal const string ObjectsDirName = "$objects$";
+        internal const string NoFile = "-";
+
+        public BackupUnit(PatchContext context) : this(context, DateTime.Now.ToString("yyyy-MM-dd_h-mm-ss"), false)
         {
         }
 
-        private BackupUnit(PatchContext context, string name)
+        private BackupUnit(PatchContext context, string name, bool isLegacy)
         {
             Name = name;
             _context = context;
+            _isLegacy = isLegacy;
             _backupPath = new DirectoryInfo(Path.Combine(_context.BackupPath, Name));
             _manifestFile = new FileInfo(Path.Combine(_backupPath.FullName, _ManifestFileName));
+            _indexFile = new FileInfo(Path.Combine(_backupPath.FullName, IndexFileName));
         }
-        
+
+        internal static string GetObjectPath(PatchContext context, string hash)
+            => Path.Combine(Path.Combine(context.BackupPath, ObjectsDirName), Path.Combine(hash.Substring(0, 2), hash));
+
         public static BackupUnit FromDirectory(DirectoryInfo directory, PatchContext context)
         {
-            var unit = new BackupUnit(context, directory.Name);
+            var indexFile = new FileInfo(Path.Combine(directory.FullName, IndexFileName));
+            var unit = new BackupUnit(context, directory.Name, !indexFile.Exists);
 
+            if (!unit._isLegacy)
+            {
+                foreach (var (relativePath, hash) in ReadIndex(indexFile.FullName))
+                {
+                    if (!unit._hashes.ContainsKey(relativePath))
+                        unit._files.Add(relativePath);
+                    unit._hashes[relativePath] = hash;
+                }
+            }
             // Read Manifest
-            if (unit._manifestFile.Exists)
+            else if (unit._manifestFile.Exists)
             {
                 var manifest = File.ReadAllText(unit._manifestFile.FullName);
                 foreach (var line in manifest.Split(new[] { Environment.NewLine }, StringSplitOptions.RemoveEmptyEntries))
@@ -53,6 +90,21 @@ namespace IPA.Patcher
             return unit;
         }
 
+        internal static IEnumerable<(string RelativePath, string Hash)> ReadIndex(string path)
+        {
+            foreach (var line in File.ReadAllLines(path))
+            {
+                var tab = line.IndexOf('\t');
+                if (tab < 0) continue;
+                yield return (line.Substring(tab + 1), line.Substring(0, tab));
+            }
+        }
+
+        /// <summary>
+        /// Gets the hashes of the objects this unit refers to.
+        /// </summary>
+        internal IEnumerable<string> ReferencedObjects => _hashes.Values.Where(h => h != NoFile);
+
         public void Add(string file)
         {
             Add(new FileInfo(file));
@@ -66,6 +118,9 @@ namespace IPA.Patcher
         /// <summary>
         /// Adds a file to the list of changed files and backups it.
         /// </summary>
+        /// <remarks>
+        /// This may be called from multiple threads at once.
+        /// </remarks>
         /// <param name="file">the file to add</param>
         public void Add(FileInfo file)
         {
@@ -76,41 +131,130 @@ namespace IPA.Patcher
             }
 
             var relativePath = file.FullName.Substring(_context.ProjectRoot.Length + 1);
-            var backupPath = new FileInfo(Path.Combine(_backupPath.FullName, relativePath));
-            
-            if(_files.Contains(relativePath))
+
+            lock (_lock)
             {
-                Console.WriteLine("Skipping backup of {0}", relativePath);
-                return;
+                if (_files.Contains(relativePath))
+                {
+                    Console.WriteLine("Skipping backup of {0}", relativePath);
+                    return;
+                }
+                _files.Add(relativePath); // claim it, so that nobody else backs it up too
             }
-            
-            // Copy over
-            backupPath.Directory?.Create();
-            if (file.Exists)
+
+            // the slow part happens outside the lock
+            string hash;
+            try
             {
-                _ = file.CopyTo(backupPath.FullName);
+                hash = file.Exists ? StoreObject(_context, file) : NoFile;
             }
-            else
+            catch
+            { // give up the claim, so that the file can be backed up again
+                lock (_lock)
+                    _ = _files.Remove(relativePath);
+                throw;
+            }
+
+            lock (_lock)
+            {
+                _hashes[relativePath] = hash;
+                AppendIndex(relativePath, hash);
+            }
+        }
+
+        /// <summary>
+        /// Copies <paramref name="file"/> into the object store, if it isn't already there.
+        /// </summary>
+        /// <returns>the hash of the file</returns>
+        internal static string StoreObject(PatchContext context, FileInfo file)
+        {
+            var hash = HashFile(file.FullName);
+            var objectPath = GetObjectPath(context, hash);
+            if (File.Exists(objectPath))
+                return hash;
+
+            _ = Directory.CreateDirectory(Path.GetDirectoryName(objectPath)!);
+            // unique, in case another thread is storing the same contents
+            var temp = objectPath + "." + Guid.NewGuid().ToString("N");
+            _ = file.CopyTo(temp);
+            try
             {
-                // Make empty file
-                //backupPath.Create().Close();
-                // don't do this bc its dumb
+                File.Move(temp, objectPath);
+            }
+            catch (IOException) when (File.Exists(objectPath))
+            { // someone else stored it first
+                File.Delete(temp);
             }
 
-            if (!File.Exists(_manifestFile.FullName))
-                _manifestFile.Create().Close();
-            var stream = _manifestFile.AppendText();
-            stream.WriteLine(relativePath);
-            stream.Close();
+            return hash;
+        }
 
-            // Add to list
-            _files.Add(relativePath);
+        internal static string HashFile(string path)
+        {
+            using var sha = SHA256.Create();
+            using var stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read, 81920, FileOptions.SequentialScan);
+            return BitConverter.ToString(sha.ComputeHash(stream)).Replace("-", "").ToLowerInvariant();
+        }
+
+        private void AppendIndex(string relativePath, string hash)
+        {
+            _backupPath.Create();
+            // a unit never backs up the same file twice, so each file gets one line, and an interrupted install
+            // leaves an index that covers everything it had replaced so far
+            File.AppendAllText(_indexFile.FullName, $"{hash}\t{relativePath}{Environment.NewLine}");
+            if (hash == NoFile)
+            { // older installers would delete anything listed here that they have no copy of, which is only right for these
+                File.AppendAllText(_manifestFile.FullName, relativePath + Environment.NewLine);
+            }
         }
 
         /// <summary>
         /// Reverts the changes made in this unit.
         /// </summary>
         public void Restore()
+        {
+            if (_isLegacy)
+            {
+                RestoreLegacy();
+                return;
+            }
+
+            _ = Parallel.ForEach(_files, relativePath =>
+            {
+                var target = new FileInfo(Path.Combine(_context.ProjectRoot, relativePath));
+                var hash = _hashes[relativePath];
+
+                if (hash == NoFile)
+                {
+                    Console.WriteLine("  x {0}", target.FullName);
+                    if (target.Exists)
+                        target.Delete();
+                    return;
+                }
+
+                // only rewrite files that actually differ from the original
+                if (target.Exists && HashFile(target.FullName) == hash)
+                    return;
+
+                var objectFile = new FileInfo(GetObjectPath(_context, hash));
+                if (!objectFile.Exists)
+                {
+                    Console.Error.WriteLine("Backup of {0} is missing! Not restoring it", relativePath);
+                    return;
+                }
+
+                Console.WriteLine("Restoring {0}", relativePath);
+                target.Directory?.Create();
+                var temp = target.FullName + ".ipa-tmp";
+                _ = objectFile.CopyTo(temp, true);
+                if (target.Exists)
+                    File.Replace(temp, target.FullName, null, true);
+                else
+                    File.Move(temp, target.FullName);
+            });
+        }
+
+        private void RestoreLegacy()
         {
             foreach(var relativePath in _files)
             {
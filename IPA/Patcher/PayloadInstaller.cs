@@ -0,0 +1,231 @@
+﻿using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Security.Cryptography;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace IPA.Patcher
+{
+    /// <summary>
+    /// Copies BSIPA's files into the game, skipping any that are already there with the same contents.
+    /// </summary>
+    /// <remarks>
+    /// <para>
+    /// The hash of every file that gets installed is recorded in a manifest next to the backups, along with the size
+    /// and modification time it had afterwards. As long as those still match, the installed file doesn't need to be
+    /// read again to know what's in it.
+    /// </para>
+    /// <para>
+    /// Files are hashed and copied in parallel. Each copy goes to a temporary file next to the target first, and then
+    /// replaces it, so an interrupted install never leaves a partially written file behind.
+    /// </para>
+    /// </remarks>
+    internal class PayloadInstaller
+    {
+        private const string ManifestFileName = "$installed$.txt";
+        private const string TempSuffix = ".ipa-tmp";
+
+        private sealed class ManifestEntry
+        {
+            public long Length;
+            public long WriteTime;
+            public string Hash = "";
+        }
+
+        private sealed class CopyJob
+        {
+            public FileInfo Source = null!;
+            public FileInfo Target = null!;
+            public string RelativePath = "";
+        }
+
+        private readonly PatchContext context;
+        private readonly BackupUnit backup;
+        private readonly bool aggressive;
+        private readonly List<CopyJob> jobs = new();
+        private readonly Dictionary<string, ManifestEntry> manifest;
+        private readonly ConcurrentDictionary<string, ManifestEntry> newManifest = new(StringComparer.OrdinalIgnoreCase);
+        private readonly object outputLock = new();
+
+        private string ManifestPath => Path.Combine(context.BackupPath, ManifestFileName);
+
+        public PayloadInstaller(PatchContext context, BackupUnit backup, bool aggressive)
+        {
+            this.context = context;
+            this.backup = backup;
+            this.aggressive = aggressive;
+            manifest = ReadManifest();
+        }
+
+        /// <summary>
+        /// Adds the files in <paramref name="source"/> to be copied to <paramref name="target"/>.
+        /// </summary>
+        public void AddDirectory(DirectoryInfo source, DirectoryInfo target, bool recurse = true)
+        {
+            foreach (var fi in source.GetFiles())
+            {
+                var targetFile = new FileInfo(Path.Combine(target.FullName, fi.Name));
+                jobs.Add(new CopyJob
+                {
+                    Source = fi,
+                    Target = targetFile,
+                    RelativePath = GetRelativePath(targetFile),
+                });
+            }
+
+            if (!recurse) return;
+            foreach (var diSourceSubDir in source.GetDirectories())
+                AddDirectory(diSourceSubDir, new DirectoryInfo(Path.Combine(target.FullName, diSourceSubDir.Name)));
+        }
+
+        /// <summary>
+        /// Copies every file that needs it, and saves the manifest.
+        /// </summary>
+        /// <returns>the number of files that were copied</returns>
+        public int Run()
+        {
+            var copied = 0;
+
+            _ = Parallel.ForEach(jobs, job =>
+            {
+                if (!NeedsCopy(job, out var sourceHash))
+                    return;
+
+                lock (outputLock)
+                    Console.WriteLine(@"Copying {0}", job.Target.FullName);
+                backup.Add(job.Target); // this has to happen before the file is replaced
+
+                CopyAtomic(job.Source, job.Target);
+                Record(job, sourceHash ?? HashFile(job.Source.FullName));
+                _ = Interlocked.Increment(ref copied);
+            });
+
+            Console.WriteLine($"Copied {copied} of {jobs.Count} files");
+            SaveManifest();
+            return copied;
+        }
+
+        private bool NeedsCopy(CopyJob job, out string? sourceHash)
+        {
+            sourceHash = null;
+            var target = job.Target;
+            if (aggressive || !target.Exists)
+                return true;
+
+            if (target.LastWriteTimeUtc >= job.Source.LastWriteTimeUtc)
+            { // the installed file is at least as new; keep what we knew about it
+                if (manifest.TryGetValue(job.RelativePath, out var known) && Matches(known, target))
+                    newManifest[job.RelativePath] = known;
+                return false;
+            }
+
+            if (target.Length != job.Source.Length)
+                return true;
+
+            // older, but possibly only because it was touched, so check whether the contents actually differ
+            var targetHash = manifest.TryGetValue(job.RelativePath, out var entry) && Matches(entry, target)
+                ? entry.Hash
+                : HashFile(target.FullName);
+            sourceHash = HashFile(job.Source.FullName);
+
+            if (sourceHash != targetHash)
+                return true;
+
+            Record(job, sourceHash);
+            return false;
+        }
+
+        private static bool Matches(ManifestEntry entry, FileInfo file)
+            => entry.Length == file.Length && entry.WriteTime == file.LastWriteTimeUtc.Ticks;
+
+        private void Record(CopyJob job, string hash)
+        {
+            job.Target.Refresh();
+            newManifest[job.RelativePath] = new ManifestEntry
+            {
+                Length = job.Target.Length,
+                WriteTime = job.Target.LastWriteTimeUtc.Ticks,
+                Hash = hash,
+            };
+        }
+
+        private static void CopyAtomic(FileInfo source, FileInfo target)
+        {
+            target.Directory?.Create();
+
+            var temp = target.FullName + TempSuffix;
+            try
+            {
+                _ = source.CopyTo(temp, true);
+                if (File.Exists(target.FullName))
+                    File.Replace(temp, target.FullName, null, true);
+                else
+                    File.Move(temp, target.FullName);
+            }
+            catch
+            {
+                try { File.Delete(temp); } catch { }
+                throw;
+            }
+        }
+
+        private static string HashFile(string path)
+        {
+            using var sha = SHA256.Create();
+            using var stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read, 81920, FileOptions.SequentialScan);
+            return BitConverter.ToString(sha.ComputeHash(stream)).Replace("-", "");
+        }
+
+        private string GetRelativePath(FileInfo file)
+            => file.FullName.StartsWith(context.ProjectRoot, StringComparison.OrdinalIgnoreCase)
+                ? file.FullName.Substring(context.ProjectRoot.Length + 1)
+                : file.FullName;
+
+        private Dictionary<string, ManifestEntry> ReadManifest()
+        {
+            var result = new Dictionary<string, ManifestEntry>(StringComparer.OrdinalIgnoreCase);
+            try
+            {
+                if (!File.Exists(ManifestPath)) return result;
+
+                foreach (var line in File.ReadAllLines(ManifestPath))
+                {
+                    var parts = line.Split('\t');
+                    if (parts.Length != 4) continue;
+                    if (!long.TryParse(parts[1], NumberStyles.Integer, CultureInfo.InvariantCulture, out var length)
+                        || !long.TryParse(parts[2], NumberStyles.Integer, CultureInfo.InvariantCulture, out var writeTime))
+                        continue;
+
+                    result[parts[0]] = new ManifestEntry { Length = length, WriteTime = writeTime, Hash = parts[3] };
+                }
+            }
+            catch (Exception e) when (e is IOException or UnauthorizedAccessException)
+            {
+                Console.Error.WriteLine("Could not read install manifest; all files will be compared directly");
+            }
+            return result;
+        }
+
+        private void SaveManifest()
+        {
+            try
+            {
+                File.WriteAllLines(ManifestPath, newManifest
+                    .OrderBy(kvp => kvp.Key, StringComparer.OrdinalIgnoreCase)
+                    .Select(kvp => string.Join("\t",
+                        kvp.Key,
+                        kvp.Value.Length.ToString(CultureInfo.InvariantCulture),
+                        kvp.Value.WriteTime.ToString(CultureInfo.InvariantCulture),
+                        kvp.Value.Hash)));
+            }
+            catch (Exception e) when (e is IOException or UnauthorizedAccessException)
+            { // the next install will just compare the files directly
+                Console.Error.WriteLine("Could not save install manifest: {0}", e.Message);
+            }
+        }
+    }
+}
@@ -214,13 +214,11 @@ namespace IPA
                     Console.ForegroundColor = ConsoleColor.DarkCyan;
                     Console.WriteLine("Installing files... ");
 
-                    CopyAll(new DirectoryInfo(context.DataPathSrc), new DirectoryInfo(context.DataPathDst), force,
-                        backup);
-                    CopyAll(new DirectoryInfo(context.LibsPathSrc), new DirectoryInfo(context.LibsPathDst), force,
-                        backup);
-                    CopyAll(new DirectoryInfo(context.IPARoot), new DirectoryInfo(context.ProjectRoot), force,
-                        backup,
-                        null, false);
+                    var installer = new PayloadInstaller(context, backup, force);
+                    installer.AddDirectory(new DirectoryInfo(context.DataPathSrc), new DirectoryInfo(context.DataPathDst));
+                    installer.AddDirectory(new DirectoryInfo(context.LibsPathSrc), new DirectoryInfo(context.LibsPathDst));
+                    installer.AddDirectory(new DirectoryInfo(context.IPARoot), new DirectoryInfo(context.ProjectRoot), false);
+                    _ = installer.Run();
                 }
                 else
                 {
@@ -295,66 +293,6 @@ namespace IPA
             }
         }
 
-        public static void ClearLine()
-        {
-            if (IsConsole)
-            {
-                Console.SetCursorPosition(0, Console.CursorTop);
-                int tpos = Console.CursorTop;
-                Console.Write(new string(' ', Console.WindowWidth));
-                Console.SetCursorPosition(0, tpos);
-            }
-        }
-
-        private static IEnumerable<FileInfo> PassThroughInterceptor(FileInfo from, FileInfo to)
-        {
-            yield return to;
-        }
-
-        public static void CopyAll(DirectoryInfo source, DirectoryInfo target, bool aggressive, BackupUnit backup,
-            Func<FileInfo, FileInfo, IEnumerable<FileInfo>>? interceptor = null, bool recurse = true)
-        {
-            if (interceptor == null)
-            {
-                interceptor = PassThroughInterceptor;
-            }
-
-            // Copy each file into the new directory.
-            foreach (var fi in source.GetFiles())
-            {
-                foreach (var targetFile in interceptor(fi, new FileInfo(Path.Combine(target.FullName, fi.Name))))
-                {
-                    if (targetFile.Exists && targetFile.LastWriteTimeUtc >= fi.LastWriteTimeUtc && !aggressive)
-                        continue;
-
-                    Debug.Assert(targetFile.Directory != null, "targetFile.Directory != null");
-                    targetFile.Directory?.Create();
-
-                    try
-                    {
-                        LineBack();
-                        ClearLine();
-                    }
-                    catch (IOException)
-                    {
-                        // Might throw due to an invalid handle when accessing IsConsole from a MSBuild task.
-                    }
-
-                    Console.WriteLine(@"Copying {0}", targetFile.FullName);
-                    backup.Add(targetFile);
-                    _ = fi.CopyTo(targetFile.FullName, true);
-                }
-            }
-
-            // Copy each subdirectory using recursion.
-            if (!recurse) return;
-            foreach (var diSourceSubDir in source.GetDirectories())
-            {
-                var nextTargetSubDir = new DirectoryInfo(Path.Combine(target.FullName, diSourceSubDir.Name));
-                CopyAll(diSourceSubDir, nextTargetSubDir, aggressive, backup, interceptor);
-            }
-        }
-
         [DoesNotReturn]
         private static void Fail(string message)
         {
@@ -430,14 +368,6 @@ namespace IPA
                 Console.Write("\r");
         }
 
-        public static void LineBack()
-        {
-            if (IsConsole)
-                Console.CursorTop--;
-            else
-                Console.Write("\x1b[1A");
-        }
-
         public static bool IsConsole => Environment.UserInteractive;
     }
 }
\ No newline at end of file
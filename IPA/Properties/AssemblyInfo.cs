@@ -1,5 +1,6 @@
 ﻿using IPA;
 using System.Reflection;
+using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
 
 // General Information about an assembly is controlled through the following
@@ -21,6 +22,7 @@ using System.Runtime.InteropServices;
 
 // The following GUID is for the ID of the typelib if this project is exposed to COM
 [assembly: Guid("14092533-98bb-40a4-9afc-27bb75672a70")]
+[assembly: InternalsVisibleTo("IPA.Tests")]
 
 // Version information for an assembly consists of the following four values:
 //